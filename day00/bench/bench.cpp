@@ -0,0 +1,534 @@
+#include <atomic>	 // allocation counters
+#include <cstdio>	 // remove
+#include <cstdlib>	 // malloc, free
+#include <fstream>	 // ofstream
+#include <new>		 // operator new
+#include <print>
+#include <ranges>	 // views
+#include <string>	 // strings
+#include <unordered_set>
+#include <vector>	 // collection
+
+#include "bench.h"
+#include "bitmap.h"
+#include "charmap.h"
+#include "dijkstra.h"
+#include "point.h"
+#include "point_map.h"
+#include "rle_charmap.h"
+#include "split.h"
+#include "thread_pool.h"
+#include "tiled_charmap.h"
+#include "vector.h"
+
+using namespace std;
+
+/* Count every heap allocation so benchmarks can report bytes/op. Atomic,
+ * as benchmarks that run on a thread_pool_t allocate from its workers too.
+ */
+std::atomic<size_t> bench_alloc_bytes = 0;
+std::atomic<size_t> bench_alloc_count = 0;
+
+void* operator new(size_t size) {
+	bench_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+	bench_alloc_count.fetch_add(1, std::memory_order_relaxed);
+
+	if (void* ptr = malloc(size ? size : 1)) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+	free(ptr);
+}
+
+void operator delete(void* ptr, [[maybe_unused]] size_t size) noexcept {
+	free(ptr);
+}
+
+/* Sizes each primitive is run at */
+static const vector<size_t> sizes = {8, 64, 512};
+
+/* Return a line of n comma separated numbers, like the puzzle inputs */
+static string number_line(size_t n) {
+	string line;
+	for (size_t i = 0; i < n; i++) {
+		if (i) {
+			line += ", ";
+		}
+		line += to_string((i * 7919) % 100000);
+	}
+	return line;
+}
+
+/* Return a size x size map of digits 1-9 */
+static charmap_t digit_map(size_t size) {
+	charmap_t map(size, size, '.');
+	for (size_t y = 0; y < size; y++) {
+		for (size_t x = 0; x < size; x++) {
+			map.set(x, y, static_cast<char>('1' + (x * 31 + y * 17) % 9));
+		}
+	}
+	return map;
+}
+
+static void bench_split() {
+	for (auto n : sizes) {
+		string line = number_line(n);
+		bench("split", n, [&line]() {
+			do_not_optimize(split(line));
+		});
+		bench("split_view", n, [&line]() {
+			size_t length = 0;
+			for (const auto token : split_view(line)) {
+				length += token.size();
+			}
+			do_not_optimize(length);
+		});
+		bench("split_int", n, [&line]() {
+			do_not_optimize(split_int(line));
+		});
+		bench("split_size_t", n, [&line]() {
+			do_not_optimize(split_size_t(line));
+		});
+		bench("parse_ints", n, [&line, n]() {
+			size_t numbers[512];
+			do_not_optimize(parse_ints<size_t>(line, span<size_t>(numbers, n)));
+			do_not_optimize(numbers);
+		});
+	}
+}
+
+/* all_xy() and all_points() as they were, iota | transform | join */
+static auto joined_xy(const charmap_t& map) {
+	return views::iota(0u, static_cast<size_t>(map.size_y)) |
+		   views::transform([&map](size_t y) {
+			   return views::iota(0u, static_cast<size_t>(map.size_x)) |
+					  views::transform([&map, y](size_t x) {
+						  return tuple<size_t, size_t, char>(x, y, map.get_unchecked(x, y));
+					  });
+		   }) |
+		   views::join;
+}
+
+static auto joined_points(const charmap_t& map) {
+	return views::iota(0u, static_cast<size_t>(map.size_y)) |
+		   views::transform([&map](size_t y) {
+			   return views::iota(0u, static_cast<size_t>(map.size_x)) |
+					  views::transform([&map, y](size_t x) {
+						  point_t p(x, y);
+						  p.w = map.get_unchecked(x, y);
+						  return p;
+					  });
+		   }) |
+		   views::join;
+}
+
+static void bench_charmap() {
+	for (auto n : sizes) {
+		charmap_t map = digit_map(n);
+		size_t cells = n * n;
+		dimension_t size = static_cast<dimension_t>(n);
+
+		bench("charmap_t::get", cells, [&map, size]() {
+			size_t sum = 0;
+			for (dimension_t y = 0; y < size; y++) {
+				for (dimension_t x = 0; x < size; x++) {
+					sum += static_cast<size_t>(map.get(x, y));
+				}
+			}
+			do_not_optimize(sum);
+		}, cells);
+
+		// load the same map from a file, read line by line or mapped
+		const string file_name = "bench_charmap.txt";
+		{
+			ofstream out(file_name);
+			for (const auto row : map.rows()) {
+				out.write(row.data(), static_cast<streamsize>(row.size())) << '\n';
+			}
+		}
+		bench("charmap_t::from_file", cells, [&file_name]() {
+			do_not_optimize(charmap_t::from_file(file_name));
+		});
+		bench("charmap_t::map_file", cells, [&file_name]() {
+			do_not_optimize(charmap_t::map_file(file_name));
+		});
+		std::remove(file_name.c_str());
+
+		charmap_t halo_map = map;
+		halo_map.add_halo();
+		bench("charmap_t::get 4-nb", cells, [&map, size]() {
+			size_t sum = 0;
+			for (dimension_t y = 0; y < size; y++) {
+				for (dimension_t x = 0; x < size; x++) {
+					sum += static_cast<size_t>(map.get(x, y - 1) + map.get(x - 1, y)
+											   + map.get(x + 1, y) + map.get(x, y + 1));
+				}
+			}
+			do_not_optimize(sum);
+		}, cells);
+
+		bench("charmap_t::get_unchecked 4-nb", cells, [&halo_map, size]() {
+			size_t sum = 0;
+			for (dimension_t y = 0; y < size; y++) {
+				for (dimension_t x = 0; x < size; x++) {
+					sum += static_cast<size_t>(halo_map.get_unchecked(x, y - 1) + halo_map.get_unchecked(x - 1, y)
+											   + halo_map.get_unchecked(x + 1, y) + halo_map.get_unchecked(x, y + 1));
+				}
+			}
+			do_not_optimize(sum);
+		}, cells);
+
+		bench("charmap_t copy", cells * sizeof(char), [&map]() {
+			charmap_t copy = map;
+			do_not_optimize(copy);
+		});
+
+		bench("charmap_t::set", cells, [&map, size]() {
+			for (dimension_t y = 0; y < size; y++) {
+				for (dimension_t x = 0; x < size; x++) {
+					map.set(x, y, '5');
+				}
+			}
+			do_not_optimize(map);
+		}, cells);
+
+		bench("charmap_t::is_valid", cells, [&map, size]() {
+			size_t valid = 0;
+			for (dimension_t y = -1; y < size - 1; y++) {
+				for (dimension_t x = -1; x < size - 1; x++) {
+					if (map.is_valid(x, y)) {
+						valid++;
+					}
+				}
+			}
+			do_not_optimize(valid);
+		}, cells);
+
+		bench("charmap_t::all_xy (join)", cells, [&map]() {
+			size_t sum = 0;
+			for (const auto [x, y, ch] : joined_xy(map)) {
+				sum += x + y + static_cast<size_t>(ch);
+			}
+			do_not_optimize(sum);
+		}, cells);
+
+		bench("charmap_t::all_xy", cells, [&map]() {
+			size_t sum = 0;
+			for (const auto [x, y, ch] : map.all_xy()) {
+				sum += x + y + static_cast<size_t>(ch);
+			}
+			do_not_optimize(sum);
+		}, cells);
+
+		bench("charmap_t::all_points (join)", cells, [&map]() {
+			size_t sum = 0;
+			for (const auto& p : joined_points(map)) {
+				sum += static_cast<size_t>(p.x + p.y + p.w);
+			}
+			do_not_optimize(sum);
+		}, cells);
+
+		bench("charmap_t::all_points", cells, [&map]() {
+			size_t sum = 0;
+			for (const auto& p : map.all_points()) {
+				sum += static_cast<size_t>(p.x + p.y + p.w);
+			}
+			do_not_optimize(sum);
+		}, cells);
+
+		bench("charmap_t::for_each_cell", cells, [&map]() {
+			size_t sum = 0;
+			map.for_each_cell([&sum](dimension_t x, dimension_t y, char ch) {
+				sum += static_cast<size_t>(x + y + ch);
+			});
+			do_not_optimize(sum);
+		}, cells);
+	}
+}
+
+/* One generation of day11's seat rule on a size x size map: a byte per
+ * cell with get() against bit planes.
+ */
+static void bench_bitmap() {
+	for (auto n : {100ul, 1000ul}) {
+		charmap_t map(n, n, 'L');
+		for (size_t y = 0; y < n; y++) {
+			for (size_t x = 0; x < n; x++) {
+				size_t h = x * 31 + y * 17;
+				map.set(x, y, h % 7 == 0 ? '.' : (h % 3 == 0 ? '#' : 'L'));
+			}
+		}
+		size_t cells = n * n;
+
+		bench("charmap_t generation", cells, [&map, n]() {
+			charmap_t next = map;
+			for (dimension_t y = 0; y < static_cast<dimension_t>(n); y++) {
+				for (dimension_t x = 0; x < static_cast<dimension_t>(n); x++) {
+					size_t count = 0;
+					for (dimension_t dy = -1; dy <= 1; dy++) {
+						for (dimension_t dx = -1; dx <= 1; dx++) {
+							if ((dx || dy) && map.get(x + dx, y + dy) == '#') {
+								count++;
+							}
+						}
+					}
+					char seat = map.get(x, y);
+					if (seat == 'L' && count == 0) {
+						next.set(x, y, '#');
+					} else if (seat == '#' && 4 <= count) {
+						next.set(x, y, 'L');
+					}
+				}
+			}
+			do_not_optimize(next);
+		}, cells);
+
+		const bitmap_t seats = bitmap_t::from_charmap(map, 'L') | bitmap_t::from_charmap(map, '#');
+		const bitmap_t occupied = bitmap_t::from_charmap(map, '#');
+		bench("bitmap_t generation", cells, [&seats, &occupied]() {
+			auto counts = occupied.neighbor_counts();
+			bitmap_t next = seats & ((~occupied & bitmap_t::count_is(counts, 0))
+									 | (occupied & ~bitmap_t::count_at_least(counts, 4)));
+			do_not_optimize(next);
+		}, cells);
+	}
+}
+
+/* Stencil and column walks on maps bigger than the cache, row-major
+ * (with a halo so there are no bounds checks) against 64x64 tiles.
+ */
+static void bench_tiled() {
+	for (auto n : {256ul, 4096ul}) {
+		charmap_t map = digit_map(n);
+		map.add_halo();
+		tiled_charmap_t tiled = tiled_charmap_t::from_charmap(map);
+		size_t cells = n * n;
+		dimension_t size = static_cast<dimension_t>(n);
+
+		bench("charmap_t 8-nb stencil", cells, [&map, size]() {
+			charmap_t next = map;
+			for (dimension_t y = 0; y < size; y++) {
+				auto row = next.row(y);
+				for (dimension_t x = 0; x < size; x++) {
+					size_t count = 0;
+					for (dimension_t dy = -1; dy <= 1; dy++) {
+						for (dimension_t dx = -1; dx <= 1; dx++) {
+							if ((dx || dy) && map.get_unchecked(x + dx, y + dy) == '5') {
+								count++;
+							}
+						}
+					}
+					row[static_cast<size_t>(x)] = count > 1 ? '5' : '1';
+				}
+			}
+			do_not_optimize(next);
+		}, cells);
+
+		bench("tiled_charmap_t 8-nb stencil", cells, [&tiled]() {
+			auto next = tiled.transform([&tiled](dimension_t x, dimension_t y, char) {
+				return tiled.count_neighbors(x, y, '5') > 1 ? '5' : '1';
+			});
+			do_not_optimize(next);
+		}, cells);
+
+		bench("charmap_t column walk", cells, [&map, size]() {
+			size_t sum = 0;
+			for (dimension_t x = 0; x < size; x++) {
+				for (dimension_t y = 0; y < size; y++) {
+					sum += static_cast<size_t>(map.get_unchecked(x, y));
+				}
+			}
+			do_not_optimize(sum);
+		}, cells);
+
+		bench("tiled_charmap_t column walk", cells, [&tiled]() {
+			size_t sum = 0;
+			tiled.for_each_tile([&sum](const auto& t) {
+				for (dimension_t x = 0; x < t.size_x; x++) {
+					for (dimension_t y = 0; y < t.size_y; y++) {
+						sum += static_cast<size_t>(t.cell(x, y));
+					}
+				}
+			});
+			do_not_optimize(sum);
+		}, cells);
+	}
+}
+
+/* Mostly '.' maps: build from points and scan, dense against runs. The
+ * largest is 64M cells dense, about 6 MB as runs (262k runs of 24 bytes).
+ */
+static void bench_rle() {
+	for (auto n : {256ul, 8192ul}) {
+		// short horizontal strokes, one every 64 cells or so
+		vector<point_t> points;
+		for (size_t i = 0; i < n * n / 256; i++) {
+			size_t h = i * 2654435761ul;
+			long x = static_cast<long>(h % n);
+			long y = static_cast<long>((h / n) % n);
+			for (long dx = 0; dx < 4; dx++) {
+				points.emplace_back(x + dx, y);
+			}
+		}
+		size_t cells = n * n;
+
+		if (n <= 256) {
+			bench("charmap_t from_points", cells, [&points]() {
+				do_not_optimize(charmap_t::from_points(points));
+			}, cells);
+
+			const charmap_t map = charmap_t::from_points(points);
+			bench("charmap_t count '#'", cells, [&map]() {
+				size_t count = 0;
+				map.for_each_cell([&count](dimension_t, dimension_t, char ch) {
+					count += static_cast<size_t>(ch == '#');
+				});
+				do_not_optimize(count);
+			}, cells);
+		}
+
+		bench("rle_charmap_t from_points", cells, [&points]() {
+			do_not_optimize(rle_charmap_t::from_points(points));
+		}, cells);
+
+		const rle_charmap_t rle = rle_charmap_t::from_points(points);
+		bench("rle_charmap_t count '#'", cells, [&rle]() {
+			size_t count = 0;
+			for (const auto& [y, runs] : rle.rows()) {
+				for (const auto& run : runs) {
+					count += run.ch == '#' ? static_cast<size_t>(run.length) : 0;
+				}
+			}
+			do_not_optimize(count);
+		}, cells);
+
+		bench("rle_charmap_t get", points.size(), [&rle, &points]() {
+			size_t count = 0;
+			for (const auto& p : points) {
+				count += static_cast<size_t>(rle.get(p.x, p.y) == '#');
+			}
+			do_not_optimize(count);
+		}, points.size());
+	}
+}
+
+static void bench_point() {
+	for (auto n : sizes) {
+		vector<point_t> points;
+		vector<string> strings;
+		for (size_t i = 0; i < n; i++) {
+			long x = static_cast<long>(i % 97) - 48;
+			long y = static_cast<long>(i / 97) - 3;
+			points.push_back({x, y, x - y, 0l});
+			strings.push_back(format("{},{},{}", x, y, x - y));
+		}
+
+		bench("std::hash<point_t>", n, [&points]() {
+			size_t h = 0;
+			for (const auto& p : points) {
+				h ^= std::hash<point_t>()(p);
+			}
+			do_not_optimize(h);
+		}, n);
+
+		bench("unordered_set<point_t> insert", n, [&points]() {
+			unordered_set<point_t> set(points.begin(), points.end());
+			do_not_optimize(set);
+		}, n);
+
+		// the same points in the 8 byte 2D point
+		vector<point<2, int32_t>> small_points;
+		for (const auto& p : points) {
+			small_points.emplace_back(p);
+		}
+		bench("unordered_set<point<2,int32>>", n, [&small_points]() {
+			unordered_set<point<2, int32_t>> set(small_points.begin(), small_points.end());
+			do_not_optimize(set);
+		}, n);
+
+		bench("point_set_t<point_t> insert", n, [&points]() {
+			point_set_t<point_t> set(points.begin(), points.end());
+			do_not_optimize(set);
+		}, n);
+
+		bench("point_set_t<point<2,int32>>", n, [&small_points]() {
+			point_set_t<point<2, int32_t>> set(small_points.begin(), small_points.end());
+			do_not_optimize(set);
+		}, n);
+
+		bench("point_t::from_string", n, [&strings]() {
+			for (const auto& s : strings) {
+				do_not_optimize(point_t::from_string(s));
+			}
+		}, n);
+	}
+}
+
+static void bench_dijkstra() {
+	thread_pool_t pool;
+	for (auto n : {8ul, 32ul, 128ul}) {
+		charmap_t map = digit_map(n);
+		vector_t start({0, 0}, {1, 0});
+		point_t end(n - 1, n - 1);
+
+		bench("dijkstra", n * n, [&map, &start, &end]() {
+			do_not_optimize(dijkstra(map, start, end));
+		});
+		bench("grid_dijkstra", n * n, [&map, &start, &end]() {
+			do_not_optimize(grid_dijkstra(map, start, end));
+		});
+		bench("grid_dijkstra radix", n * n, [&map, &start, &end]() {
+			do_not_optimize(grid_dijkstra(map, start, end, nullptr, 0));
+		});
+		bench("grid_astar", n * n, [&map, &start, &end]() {
+			do_not_optimize(grid_astar(map, start, end));
+		});
+		bench("grid_bidirectional", n * n, [&map, &start, &end]() {
+			do_not_optimize(grid_bidirectional(map, {start}, end));
+		});
+		bench("grid_delta_stepping", n * n, [&map, &start, &end, &pool]() {
+			do_not_optimize(grid_delta_stepping(map, {start}, end, pool));
+		});
+
+		charmap_graph_t graph(map);
+		bench("graph_dijkstra charmap", n * n, [&graph, &start, &end]() {
+			do_not_optimize(graph_dijkstra(graph, {graph.state(start)}, graph.at(end)));
+		});
+
+		vector<csr_graph_t::edge_t> edges;
+		for (size_t u = 0; u < graph.size(); u++) {
+			for (const auto v : graph.neighbours(u)) {
+				edges.emplace_back(static_cast<uint32_t>(u), v, graph.weight(u, v));
+			}
+		}
+		const csr_graph_t csr = csr_graph_t::from_edges(graph.size(), edges);
+		bench("graph_dijkstra csr", n * n, [&graph, &csr, &start, &end]() {
+			do_not_optimize(graph_dijkstra(csr, {graph.state(start)}, graph.at(end)));
+		});
+	}
+}
+
+int main(int argc, char* argv[]) {
+	// optional argument, only run benchmarks whose group contains it
+	string only = argc > 1 ? argv[1] : "";
+
+	vector<pair<string, void (*)()>> groups = {
+		{"split", bench_split},
+		{"charmap", bench_charmap},
+		{"bitmap", bench_bitmap},
+		{"tiled", bench_tiled},
+		{"rle", bench_rle},
+		{"point", bench_point},
+		{"dijkstra", bench_dijkstra},
+	};
+
+	print_bench_header();
+	for (const auto& [group, fn] : groups) {
+		if (group.find(only) != string::npos) {
+			fn();
+		}
+	}
+}
@@ -0,0 +1,114 @@
+#if !defined(BENCH_H)
+#define BENCH_H
+
+#include <algorithm>  // sort
+#include <atomic>	  // allocation counters
+#include <chrono>	  // high resolution timer
+#include <cstddef>	  // size_t
+#include <print>	  // print
+#include <string>	  // std::string
+#include <vector>	  // std::vector
+
+/* Tiny microbenchmark harness for the day00 library.
+ *
+ *	bench("split", line.size(), [&line]() {
+ *		do_not_optimize(split(line));
+ *	});
+ *
+ * Calibrates the iteration count until a sample runs for at least
+ * bench_min_time, takes the best of bench_samples samples, and reports
+ * ns/op and heap bytes/op and allocations/op (counted by bench.cpp's
+ * operator new).
+ */
+
+/* Heap use since start, kept by the operator new in bench.cpp */
+extern std::atomic<size_t> bench_alloc_bytes;
+extern std::atomic<size_t> bench_alloc_count;
+
+using bench_clock_t = std::chrono::high_resolution_clock;
+
+constexpr std::chrono::milliseconds bench_min_time{20};
+constexpr size_t bench_samples = 5;
+
+/* Make the compiler believe value is used, so the work is not thrown away. */
+template <typename T>
+inline void do_not_optimize(const T& value) {
+	asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/* Make the compiler believe all memory was read and written. */
+inline void clobber_memory() {
+	asm volatile("" : : : "memory");
+}
+
+struct bench_result_t {
+	std::string name = "";
+	size_t size = 0;
+	size_t iterations = 0;
+	double ns_per_op = 0;
+	double bytes_per_op = 0;
+	double allocs_per_op = 0;
+};
+
+inline void print_bench_header() {
+	std::print("{:<32} {:>10} {:>12} {:>12} {:>10} {:>10}\n",
+			   "benchmark", "size", "iterations", "ns/op", "B/op", "allocs/op");
+}
+
+inline void print_bench(const bench_result_t& r) {
+	std::print("{:<32} {:>10} {:>12} {:>12.2f} {:>10.1f} {:>10.2f}\n",
+			   r.name, r.size, r.iterations, r.ns_per_op, r.bytes_per_op, r.allocs_per_op);
+}
+
+/* Time fn() run `iterations` times, returns nanoseconds. */
+template <typename F>
+double bench_run(F& fn, size_t iterations) {
+	auto start = bench_clock_t::now();
+	for (size_t i = 0; i < iterations; i++) {
+		fn();
+		clobber_memory();
+	}
+	std::chrono::duration<double, std::nano> elapsed = bench_clock_t::now() - start;
+	return elapsed.count();
+}
+
+/* Benchmark fn, `size` is the input size shown with the result.
+ * If one call of fn does `ops` operations (e.g. a get() for every cell of a
+ * map), the results are per operation rather than per call.
+ */
+template <typename F>
+bench_result_t bench(const std::string& name, size_t size, F fn, size_t ops = 1) {
+	// calibrate: double the iterations until a run is long enough to time
+	size_t iterations = 1;
+	while (bench_run(fn, iterations) < std::chrono::duration<double, std::nano>(bench_min_time).count()) {
+		iterations *= 2;
+	}
+
+	std::vector<double> samples;
+	for (size_t s = 0; s < bench_samples; s++) {
+		samples.push_back(bench_run(fn, iterations));
+	}
+	std::sort(samples.begin(), samples.end());
+
+	// heap use of one more run
+	size_t bytes = bench_alloc_bytes.load(std::memory_order_relaxed);
+	size_t count = bench_alloc_count.load(std::memory_order_relaxed);
+	bench_run(fn, iterations);
+	bytes = bench_alloc_bytes.load(std::memory_order_relaxed) - bytes;
+	count = bench_alloc_count.load(std::memory_order_relaxed) - count;
+
+	bench_result_t result;
+	result.name = name;
+	result.size = size;
+	result.iterations = iterations;
+
+	double total_ops = static_cast<double>(iterations * ops);
+	result.ns_per_op = samples[0] / total_ops;
+	result.bytes_per_op = static_cast<double>(bytes) / total_ops;
+	result.allocs_per_op = static_cast<double>(count) / total_ops;
+
+	print_bench(result);
+	return result;
+}
+
+#endif
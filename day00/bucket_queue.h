@@ -0,0 +1,167 @@
+#if !defined(BUCKET_QUEUE_T_H)
+#define BUCKET_QUEUE_T_H
+
+#include <algorithm>	// min
+#include <array>	// radix buckets
+#include <bit>		// bit_width
+#include <cassert>
+#include <cstddef>	// size_t
+#include <utility>	// pair
+#include <vector>	// std::vector
+
+/* Monotone priority queues for Dijkstra: every key pushed is at least the
+ * last key popped. Both hand back (key, value) with the smallest key first;
+ * equal keys come out in no particular order.
+ */
+
+/* Radix heap: a bucket per bit, key goes in the bucket of the highest bit
+ * where it differs from the last key popped. When bucket 0 (keys equal to
+ * the last one) runs dry, the first bucket that is not empty is spread out
+ * again around its smallest key. Each entry moves down at most 64 times, so
+ * any size of key is amortised O(log C).
+ */
+template <typename V>
+struct radix_heap_t {
+	using entry_t = std::pair<size_t, V>;
+
+	explicit radix_heap_t(size_t last = 0) : last(last) {
+	}
+
+	bool empty() const {
+		return this->count == 0;
+	}
+
+	size_t size() const {
+		return this->count;
+	}
+
+	void push(size_t key, const V& value) {
+		assert(key >= this->last);
+		this->buckets[this->bucket_of(key)].emplace_back(key, value);
+		this->count++;
+	}
+
+	entry_t pop() {
+		assert(!this->empty());
+		if (this->buckets[0].empty()) {
+			size_t i = 1;
+			while (this->buckets[i].empty()) {
+				i++;
+			}
+
+			auto& from = this->buckets[i];
+			this->last = from.front().first;
+			for (const auto& entry : from) {
+				this->last = std::min(this->last, entry.first);
+			}
+			for (const auto& entry : from) {
+				this->buckets[this->bucket_of(entry.first)].push_back(entry);
+			}
+			from.clear();
+		}
+
+		entry_t entry = this->buckets[0].back();
+		this->buckets[0].pop_back();
+		this->count--;
+		return entry;
+	}
+
+   private:
+	std::array<std::vector<entry_t>, 65> buckets = {};
+	size_t last = 0;
+	size_t count = 0;
+
+	size_t bucket_of(size_t key) const {
+		return static_cast<size_t>(std::bit_width(key ^ this->last));
+	}
+};
+
+/* Dial's algorithm: when no edge costs more than max_weight, every key in
+ * the queue is within max_weight of the last one popped, so max_weight + 1
+ * buckets used as a ring, one per key, hold them all. push() and pop() are
+ * O(1) plus the empty buckets skipped, and nothing is compared.
+ *
+ * A key further out than that (an edge heavier than promised, or a first
+ * key far above first_key) moves everything into a radix_heap_t, which
+ * carries on from there.
+ *
+ *	bucket_queue_t<uint32_t> Q(9);	// digit costs
+ *	Q.push(0, start);
+ *	while (!Q.empty()) {
+ *		auto [cost, u] = Q.pop();
+ *		...
+ *	}
+ */
+template <typename V>
+struct bucket_queue_t {
+	// no key pushed will be below first_key
+	explicit bucket_queue_t(size_t max_weight, size_t first_key = 0)
+		: buckets(max_weight + 1), current(first_key) {
+	}
+
+	bool empty() const {
+		return this->count == 0;
+	}
+
+	size_t size() const {
+		return this->count;
+	}
+
+	// true once a key too far out has sent everything to the radix heap
+	bool overflowed() const {
+		return this->use_heap;
+	}
+
+	void push(size_t key, const V& value) {
+		assert(key >= this->current);
+		if (!this->use_heap && key - this->current >= this->buckets.size()) {
+			this->to_heap();
+		}
+		if (this->use_heap) {
+			this->heap.push(key, value);
+		} else {
+			this->buckets[key % this->buckets.size()].push_back(value);
+		}
+		this->count++;
+	}
+
+	std::pair<size_t, V> pop() {
+		assert(!this->empty());
+		this->count--;
+		if (this->use_heap) {
+			return this->heap.pop();
+		}
+
+		size_t slot = this->current % this->buckets.size();
+		while (this->buckets[slot].empty()) {
+			this->current++;
+			slot = slot + 1 == this->buckets.size() ? 0 : slot + 1;
+		}
+		V value = this->buckets[slot].back();
+		this->buckets[slot].pop_back();
+		return {this->current, value};
+	}
+
+   private:
+	std::vector<std::vector<V>> buckets;
+	size_t current;	 // key of the bucket pop() looks at first
+	size_t count = 0;
+	bool use_heap = false;
+	radix_heap_t<V> heap{};
+
+	void to_heap() {
+		this->heap = radix_heap_t<V>(this->current);
+		const size_t n = this->buckets.size();
+		for (size_t i = 0; i < n; i++) {
+			// the ring holds keys current .. current + n - 1
+			size_t key = this->current + (i + n - this->current % n) % n;
+			for (const auto& value : this->buckets[i]) {
+				this->heap.push(key, value);
+			}
+			this->buckets[i].clear();
+		}
+		this->use_heap = true;
+	}
+};
+
+#endif
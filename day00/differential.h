@@ -0,0 +1,136 @@
+#if !defined(DIFFERENTIAL_H)
+#define DIFFERENTIAL_H
+
+#include <concepts>	   // constructible_from
+#include <cstddef>	   // size_t
+#include <functional>  // std::function
+#include <iterator>	   // iterator_t
+#include <print>	   // print
+#include <ranges>	   // ranges::range
+#include <string>	   // std::string
+#include <vector>	   // std::vector
+
+/* Differential testing: run a trusted (slow) reference implementation and an
+ * optimized one on the same data and make sure they agree. When they do not,
+ * shrink the data down to a small counterexample that still disagrees.
+ *
+ * A day registers its pairs and (optionally) a generator for random inputs,
+ *
+ *	const vector<differential_t<data_t, result_t>> differentials = {
+ *		{"part1", part1_reference, part1},
+ *	};
+ *
+ * and main() runs them with -d (on the input file) or -g size (on generated
+ * inputs of the given size).
+ */
+template <typename D, typename R>
+struct differential_t {
+	std::string name;
+	std::function<R(const D&)> reference;
+	std::function<R(const D&)> optimized;
+
+	bool disagrees(const D& data) const {
+		return reference(data) != optimized(data);
+	}
+};
+
+/* Return a smaller data that still makes check disagree.
+ * Works on any container that can be rebuilt from an iterator range
+ * (vector, unordered_set, ...) by dropping chunks of elements, halving the
+ * chunk size whenever nothing more can be dropped (a simple ddmin).
+ * Other data types are returned as is.
+ */
+template <typename D, typename R>
+D shrink(const D& data, const differential_t<D, R>& check) {
+	if constexpr (std::ranges::range<D> &&
+				  std::constructible_from<D, typename std::vector<std::ranges::range_value_t<D>>::iterator,
+										  typename std::vector<std::ranges::range_value_t<D>>::iterator>) {
+		std::vector<std::ranges::range_value_t<D>> items(data.begin(), data.end());
+
+		size_t chunk = items.size() / 2;
+		while (chunk > 0) {
+			bool dropped = false;
+
+			for (size_t start = 0; start < items.size();) {
+				auto candidate = items;
+				auto first = candidate.begin() + static_cast<std::ptrdiff_t>(start);
+				auto last = candidate.begin() + static_cast<std::ptrdiff_t>(std::min(start + chunk, items.size()));
+				candidate.erase(first, last);
+
+				if (check.disagrees(D(candidate.begin(), candidate.end()))) {
+					items.swap(candidate);
+					dropped = true;
+				} else {
+					start += chunk;
+				}
+			}
+
+			if (!dropped) {
+				chunk /= 2;
+			}
+		}
+
+		return D(items.begin(), items.end());
+	} else {
+		return data;
+	}
+}
+
+/* Show both results and (if it can be printed) the data that disagrees. */
+template <typename D, typename R>
+void print_counterexample(const D& data, const differential_t<D, R>& check) {
+	std::print("{:>15} reference={} optimized={}\n", check.name, check.reference(data), check.optimized(data));
+
+	if constexpr (std::ranges::range<D>) {
+		std::print("{:>15} ", "input");
+		for (const auto& item : data) {
+			std::print("{} ", item);
+		}
+		std::print("\n");
+	}
+}
+
+/* Run all checks on data, returns true if they all agree. */
+template <typename D, typename R>
+bool run_differentials(const std::vector<differential_t<D, R>>& checks, const D& data) {
+	bool ok = true;
+
+	for (const auto& check : checks) {
+		if (check.disagrees(data)) {
+			ok = false;
+			print_counterexample(shrink(data, check), check);
+		} else {
+			std::print("{:>15} ok\n", check.name);
+		}
+	}
+
+	return ok;
+}
+
+/* Run all checks on `rounds` generated inputs, stops at the first mismatch.
+ * generate(size, seed) makes a random input of about `size`.
+ */
+template <typename D, typename R>
+bool run_differentials(const std::vector<differential_t<D, R>>& checks,
+					   std::function<D(size_t size, unsigned seed)> generate,
+					   size_t size, size_t rounds = 100) {
+	for (unsigned seed = 0; seed < rounds; seed++) {
+		D data = generate(size, seed);
+
+		for (const auto& check : checks) {
+			if (check.disagrees(data)) {
+				std::print("{:>15} mismatch on seed {}\n", check.name, seed);
+				print_counterexample(shrink(data, check), check);
+				return false;
+			}
+		}
+	}
+
+	for (const auto& check : checks) {
+		std::print("{:>15} ok ({} inputs)\n", check.name, rounds);
+	}
+
+	return true;
+}
+
+#endif
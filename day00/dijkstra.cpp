@@ -3,11 +3,15 @@
 
 #include <limits.h>
 
+#include <algorithm>  // min, reverse
+#include <atomic>	  // delta-stepping labels
 #include <queue>
 #include <vector>
 
+#include "bucket_queue.h"
 #include "charmap.h"
 #include "point.h"
+#include "thread_pool.h"
 
 /* *** Dijkstra *** */
 
@@ -48,8 +52,7 @@ std::tuple<size_t, dist_t, pred_t>
 dijkstra(const charmap_t& map,
 		 const vector_t& start,
 		 const point_t& end,
-		 size_t (*cost_fn)(const size_t cost, const vector_t& current,
-						   const vector_t& neighbor, const charmap_t& map)) {
+		 cost_fn_t cost_fn) {
 	dist_t dist;
 	pred_t pred;
 	std::priority_queue<vector_t, std::vector<vector_t>, compare_cost> Q;
@@ -155,6 +158,491 @@ std::vector<point_t> dijkstra_path(const point_t& end, const pred_t& pred) {
 	return path;
 }
 
+/* *** Grid Dijkstra *** */
+
+// index of dir in directions, 4 if it is not one of them
+static size_t direction_index(const point_t& dir) {
+	size_t d = 0;
+	while (d < directions.size() && directions[d] != dir) {
+		d++;
+	}
+	return d;
+}
+
+grid_dist_t::grid_dist_t(const charmap_t& map, const std::vector<vector_t>& sources)
+	: size_x(map.size_x), size_y(map.size_y) {
+	for (const auto& source : sources) {
+		if (direction_index(source.dir) == directions.size()) {
+			this->undirected.push_back(source);
+		}
+	}
+
+	const size_t states = static_cast<size_t>(map.size_x * map.size_y) * directions.size() + this->undirected.size();
+	assert(states < no_parent);
+	this->dist.assign(states, unreached);
+	this->parent.assign(states, no_parent);
+}
+
+size_t grid_dist_t::state(const vector_t& v) const {
+	const size_t grid_states = static_cast<size_t>(this->size_x * this->size_y) * directions.size();
+	size_t d = direction_index(v.dir);
+	if (d == directions.size()) {
+		auto it = std::find(this->undirected.begin(), this->undirected.end(), v);
+		assert(it != this->undirected.end());
+		return grid_states + static_cast<size_t>(it - this->undirected.begin());
+	}
+	return static_cast<size_t>(v.p.y * this->size_x + v.p.x) * directions.size() + d;
+}
+
+vector_t grid_dist_t::vertex(size_t state) const {
+	const size_t grid_states = static_cast<size_t>(this->size_x * this->size_y) * directions.size();
+	if (state >= grid_states) {
+		return this->undirected[state - grid_states];
+	}
+	size_t cell = state / directions.size();
+	point_t p(static_cast<dimension_t>(cell) % this->size_x, static_cast<dimension_t>(cell) / this->size_x);
+	return {p, directions[state % directions.size()]};
+}
+
+// f(state) for the states at p, the 4 directions and any undirected sources there
+template <typename F>
+static void for_each_state_at(const grid_dist_t& grid, const point_t& p, F&& f) {
+	const size_t cell = static_cast<size_t>(p.y * grid.size_x + p.x);
+	for (size_t d = 0; d < directions.size(); d++) {
+		f(cell * directions.size() + d);
+	}
+	for (size_t i = 0; i < grid.undirected.size(); i++) {
+		if (grid.undirected[i].p == p) {
+			f(grid.dist.size() - grid.undirected.size() + i);
+		}
+	}
+}
+
+size_t grid_dist_t::distance(const point_t& p) const {
+	size_t distance = unreached;
+	for_each_state_at(*this, p, [this, &distance](size_t s) {
+		distance = std::min(distance, this->dist[s]);
+	});
+	return distance;
+}
+
+std::vector<point_t> grid_dist_t::path(const point_t& end) const {
+	std::vector<point_t> path;
+	if (this->distance(end) == unreached) {
+		return path;
+	}
+
+	size_t best = no_parent;
+	for_each_state_at(*this, end, [this, &best](size_t s) {
+		if (best == no_parent || this->dist[s] < this->dist[best]) {
+			best = s;
+		}
+	});
+
+	for (size_t s = best;; s = this->parent[s]) {
+		path.push_back(this->vertex(s).p);
+		if (this->parent[s] == no_parent) {
+			break;
+		}
+	}
+	std::reverse(path.begin(), path.end());
+	return path;
+}
+
+/* grid_dijkstra() and grid_astar(): states come off the queue in order of
+ * cost so far + heuristic(p, end), 0 for plain Dijkstra.
+ */
+template <typename H>
+static grid_dist_t grid_search(const charmap_t& map,
+							   const std::vector<vector_t>& sources,
+							   const point_t& end,
+							   cost_fn_t cost_fn,
+							   size_t max_weight,
+							   H heuristic) {
+	grid_dist_t result(map, sources);
+
+	if (cost_fn == nullptr) {
+		cost_fn = default_cost;
+	}
+
+	size_t first_estimate = grid_dist_t::unreached;
+	for (const auto& source : sources) {
+		first_estimate = std::min(first_estimate, heuristic(source.p, end));
+	}
+	bucket_queue_t<uint32_t> Q(max_weight, sources.empty() ? 0 : first_estimate);
+	for (const auto& source : sources) {
+		const size_t s = result.state(source);
+		result.dist[s] = 0;
+		Q.push(heuristic(source.p, end), static_cast<uint32_t>(s));
+	}
+
+	// expanded at its current cost; reached cheaper later opens it again
+	std::vector<uint8_t> closed(result.dist.size(), 0);
+
+	while (!Q.empty()) {
+		auto [estimate, s] = Q.pop();
+		if (closed[s]) {
+			continue;  // already expanded at this cost, this entry is stale
+		}
+		closed[s] = 1;
+		const size_t cost = result.dist[s];
+
+		vector_t u = result.vertex(s);
+		if (u.p == end) {
+			result.min_cost = cost;
+			break;
+		}
+		result.expanded++;
+
+		for (size_t d = 0; d < directions.size(); d++) {
+			vector_t v(u.p + directions[d], directions[d]);
+			if (!map.is_valid(v.p)) {
+				continue;
+			}
+
+			size_t neighbor_cost = cost_fn(cost, u, v, map);
+			assert(neighbor_cost >= cost);
+
+			const size_t t = static_cast<size_t>(v.p.y * map.size_x + v.p.x) * directions.size() + d;
+			if (neighbor_cost < result.dist[t]) {
+				result.dist[t] = neighbor_cost;
+				result.parent[t] = s;
+				closed[t] = 0;
+				// pathmax: never below the estimate of the state it came from,
+				// so keys do not go down even when the heuristic drops by more
+				// than a step costs
+				Q.push(std::max(neighbor_cost + heuristic(v.p, end), estimate), static_cast<uint32_t>(t));
+			}
+		}
+	}
+
+	return result;
+}
+
+grid_dist_t grid_dijkstra(const charmap_t& map,
+						  const vector_t& start,
+						  const point_t& end,
+						  cost_fn_t cost_fn,
+						  size_t max_weight) {
+	return grid_dijkstra(map, std::vector<vector_t>{start}, end, cost_fn, max_weight);
+}
+
+grid_dist_t grid_dijkstra(const charmap_t& map,
+						  const std::vector<vector_t>& sources,
+						  const point_t& end,
+						  cost_fn_t cost_fn,
+						  size_t max_weight) {
+	auto no_heuristic = [](const point_t&, const point_t&) { return size_t{0}; };
+	return grid_search(map, sources, end, cost_fn, max_weight, no_heuristic);
+}
+
+// Steps left if every one costs at least 1
+static size_t manhattan_heuristic(const point_t& p, const point_t& end) {
+	return static_cast<size_t>(manhattan_distance(p, end));
+}
+
+grid_dist_t grid_astar(const charmap_t& map,
+					   const vector_t& start,
+					   const point_t& end,
+					   cost_fn_t cost_fn,
+					   heuristic_fn_t heuristic,
+					   size_t max_weight) {
+	return grid_astar(map, std::vector<vector_t>{start}, end, cost_fn, heuristic, max_weight);
+}
+
+grid_dist_t grid_astar(const charmap_t& map,
+					   const std::vector<vector_t>& sources,
+					   const point_t& end,
+					   cost_fn_t cost_fn,
+					   heuristic_fn_t heuristic,
+					   size_t max_weight) {
+	if (heuristic == nullptr) {
+		heuristic = manhattan_heuristic;
+	}
+	// a step changes cost + manhattan distance by its cost - 1 to cost + 1
+	return grid_search(map, sources, end, cost_fn, max_weight + 1, heuristic);
+}
+
+grid_path_t grid_bidirectional(const charmap_t& map,
+							   const std::vector<vector_t>& sources,
+							   const point_t& end,
+							   cost_fn_t cost_fn,
+							   size_t max_weight) {
+	if (cost_fn == nullptr) {
+		cost_fn = default_cost;
+	}
+
+	// same states both ways; backward's dist is the cost on to end, its
+	// parent the next state on the way there
+	grid_dist_t forward(map, sources);
+	grid_dist_t backward(map, sources);
+	const size_t grid_states = forward.dist.size() - forward.undirected.size();
+	bucket_queue_t<uint32_t> forward_Q(max_weight);
+	bucket_queue_t<uint32_t> backward_Q(max_weight);
+
+	// best cost through a state both have reached
+	size_t best = grid_dist_t::unreached;
+	size_t meet = 0;
+	auto met = [&forward, &backward, &best, &meet](size_t s) {
+		if (forward.dist[s] != grid_dist_t::unreached && backward.dist[s] != grid_dist_t::unreached
+			&& forward.dist[s] + backward.dist[s] < best) {
+			best = forward.dist[s] + backward.dist[s];
+			meet = s;
+		}
+	};
+
+	for (const auto& source : sources) {
+		const size_t s = forward.state(source);
+		forward.dist[s] = 0;
+		forward_Q.push(0, static_cast<uint32_t>(s));
+	}
+	if (map.is_valid(end)) {
+		for_each_state_at(backward, end, [&backward, &backward_Q, &met](size_t s) {
+			backward.dist[s] = 0;
+			backward_Q.push(0, static_cast<uint32_t>(s));
+			met(s);
+		});
+	}
+
+	size_t expanded = 0;
+	size_t forward_cost = 0;   // last taken off each queue
+	size_t backward_cost = 0;
+	bool forward_turn = true;
+	while (!forward_Q.empty() || !backward_Q.empty()) {
+		const bool is_forward = backward_Q.empty() || (forward_turn && !forward_Q.empty());
+		forward_turn = !forward_turn;
+
+		if (is_forward) {
+			auto [cost, s] = forward_Q.pop();
+			if (cost > forward.dist[s]) {
+				continue;
+			}
+			forward_cost = cost;
+			if (forward_cost + backward_cost >= best) {
+				break;	// nothing either side has left can do better
+			}
+			expanded++;
+
+			vector_t u = forward.vertex(s);
+			for (size_t d = 0; d < directions.size(); d++) {
+				vector_t v(u.p + directions[d], directions[d]);
+				if (!map.is_valid(v.p)) {
+					continue;
+				}
+
+				size_t neighbor_cost = cost_fn(cost, u, v, map);
+				const size_t t = static_cast<size_t>(v.p.y * map.size_x + v.p.x) * directions.size() + d;
+				if (neighbor_cost < forward.dist[t]) {
+					forward.dist[t] = neighbor_cost;
+					forward.parent[t] = s;
+					forward_Q.push(neighbor_cost, static_cast<uint32_t>(t));
+					met(t);
+				}
+			}
+		} else {
+			auto [cost, s] = backward_Q.pop();
+			if (cost > backward.dist[s]) {
+				continue;
+			}
+			backward_cost = cost;
+			if (forward_cost + backward_cost >= best) {
+				break;
+			}
+			expanded++;
+
+			// nothing leads into an undirected source
+			if (s >= grid_states) {
+				continue;
+			}
+
+			// v was entered from the cell behind it, in any of its states
+			vector_t v = backward.vertex(s);
+			point_t behind = v.p - v.dir;
+			if (!map.is_valid(behind)) {
+				continue;
+			}
+			for_each_state_at(backward, behind, [&, cost = cost, s = s](size_t t) {
+				size_t previous_cost = cost + cost_fn(0, backward.vertex(t), v, map);
+				if (previous_cost < backward.dist[t]) {
+					backward.dist[t] = previous_cost;
+					backward.parent[t] = static_cast<uint32_t>(s);
+					backward_Q.push(previous_cost, static_cast<uint32_t>(t));
+					met(t);
+				}
+			});
+		}
+	}
+
+	grid_path_t result;
+	result.expanded = expanded;
+	if (best == grid_dist_t::unreached) {
+		return result;
+	}
+
+	result.min_cost = best;
+	for (size_t s = meet; s != grid_dist_t::no_parent; s = forward.parent[s]) {
+		result.path.push_back(forward.vertex(s).p);
+	}
+	std::reverse(result.path.begin(), result.path.end());
+	for (size_t s = backward.parent[meet]; s != grid_dist_t::no_parent; s = backward.parent[s]) {
+		result.path.push_back(backward.vertex(s).p);
+	}
+	return result;
+}
+
+grid_dist_t grid_delta_stepping(const charmap_t& map,
+								const std::vector<vector_t>& sources,
+								const point_t& end,
+								thread_pool_t& pool,
+								cost_fn_t cost_fn,
+								size_t delta) {
+	assert(delta > 0);
+	if (cost_fn == nullptr) {
+		cost_fn = default_cost;
+	}
+
+	grid_dist_t result(map, sources);
+	const size_t states = result.dist.size();
+
+	// cost << 32 | parent, so a cost and its parent change together
+	constexpr uint64_t unlabelled = ~uint64_t{0};
+	std::vector<std::atomic<uint64_t>> label(states);
+	pool.parallel_for(states, [&label](size_t begin, size_t end, size_t) {
+		for (size_t s = begin; s < end; s++) {
+			label[s].store(unlabelled, std::memory_order_relaxed);
+		}
+	});
+	auto cost_of = [&label](size_t s) {
+		return static_cast<size_t>(label[s].load(std::memory_order_relaxed) >> 32);
+	};
+
+	// atomic min, true if it was lowered
+	auto relax = [&label](size_t s, size_t cost, size_t parent) {
+		assert(cost < UINT32_MAX);
+		const uint64_t lower = static_cast<uint64_t>(cost) << 32 | parent;
+		uint64_t old = label[s].load(std::memory_order_relaxed);
+		while ((old >> 32) > cost) {
+			if (label[s].compare_exchange_weak(old, lower, std::memory_order_relaxed)) {
+				return true;
+			}
+		}
+		return false;
+	};
+
+	// the buckets may hold states more than once, or that have moved on
+	// to a lower bucket; both are dropped as each bucket is taken
+	std::vector<std::vector<uint32_t>> buckets;
+	auto add = [&buckets, &cost_of, delta](size_t s) {
+		size_t b = cost_of(s) / delta;
+		if (b >= buckets.size()) {
+			buckets.resize(b + 1);
+		}
+		buckets[b].push_back(static_cast<uint32_t>(s));
+	};
+
+	for (const auto& source : sources) {
+		const size_t s = result.state(source);
+		relax(s, 0, grid_dist_t::no_parent);
+		add(s);
+	}
+
+	// states whose cost each worker lowered, added to buckets after each round
+	std::vector<std::vector<uint32_t>> lowered(pool.size());
+	auto add_lowered = [&lowered, &add]() {
+		for (auto& states : lowered) {
+			for (const auto s : states) {
+				add(s);
+			}
+			states.clear();
+		}
+	};
+
+	// f(v, t, cost) for the steps out of state s whose cost (light or heavy) is wanted
+	auto steps = [&map, &result, &cost_of, cost_fn, delta](size_t s, bool light, auto&& f) {
+		const size_t cost = cost_of(s);
+		vector_t u = result.vertex(s);
+		for (size_t d = 0; d < directions.size(); d++) {
+			vector_t v(u.p + directions[d], directions[d]);
+			if (!map.is_valid(v.p)) {
+				continue;
+			}
+			size_t neighbor_cost = cost_fn(cost, u, v, map);
+			if ((neighbor_cost - cost <= delta) == light) {
+				f(static_cast<size_t>(v.p.y * map.size_x + v.p.x) * directions.size() + d, neighbor_cost);
+			}
+		}
+	};
+
+	auto expand = [&pool, &lowered, &relax, &steps](const std::vector<uint32_t>& frontier, bool light) {
+		pool.parallel_for(frontier.size(), [&](size_t begin, size_t end, size_t worker) {
+			for (size_t i = begin; i < end; i++) {
+				const size_t s = frontier[i];
+				steps(s, light, [&](size_t t, size_t neighbor_cost) {
+					if (relax(t, neighbor_cost, s)) {
+						lowered[worker].push_back(static_cast<uint32_t>(t));
+					}
+				});
+			}
+		}, 64);
+	};
+
+	// marks so each state is in a frontier, and in settled, once
+	std::vector<uint32_t> in_frontier(states, 0);
+	std::vector<uint32_t> in_settled(states, 0);
+	uint32_t round = 0;
+
+	for (size_t i = 0; i < buckets.size(); i++) {
+		std::vector<uint32_t> settled;
+
+		while (!buckets[i].empty()) {
+			round++;
+			std::vector<uint32_t> frontier;
+			for (const auto s : buckets[i]) {
+				if (cost_of(s) / delta == i && in_frontier[s] != round) {
+					in_frontier[s] = round;
+					frontier.push_back(s);
+					if (in_settled[s] != static_cast<uint32_t>(i + 1)) {
+						in_settled[s] = static_cast<uint32_t>(i + 1);
+						settled.push_back(s);
+					}
+				}
+			}
+			buckets[i].clear();
+
+			result.expanded += frontier.size();
+			expand(frontier, true);
+			add_lowered();
+		}
+
+		expand(settled, false);
+		add_lowered();
+
+		// everything below the next bucket has its final cost
+		size_t end_cost = grid_dist_t::unreached;
+		if (map.is_valid(end)) {
+			for_each_state_at(result, end, [&end_cost, &cost_of](size_t s) {
+				end_cost = std::min(end_cost, cost_of(s));
+			});
+		}
+		if (end_cost < (i + 1) * delta) {
+			result.min_cost = end_cost;
+			break;
+		}
+	}
+
+	pool.parallel_for(states, [&result, &label](size_t begin, size_t end, size_t) {
+		for (size_t s = begin; s < end; s++) {
+			const uint64_t l = label[s].load(std::memory_order_relaxed);
+			if (l != unlabelled) {
+				result.dist[s] = static_cast<size_t>(l >> 32);
+				result.parent[s] = static_cast<uint32_t>(l);
+			}
+		}
+	});
+
+	return result;
+}
+
 void show_dijkstra_distances(const charmap_t& map, const dist_t& dist) {
 	int x_width = 4;
 
@@ -171,11 +659,11 @@ void show_dijkstra_distances(const charmap_t& map, const dist_t& dist) {
 	std::cout << "-+-\n";
 
 	size_t y = 0;
-	for (auto yit = map.data.begin(); yit != map.data.end(); ++yit) {
+	for (const auto row : map.rows()) {
 		std::cout << y % 10 << "| ";
 
 		size_t x = 0;
-		for (auto xit = (*yit).begin(); xit != (*yit).end(); ++xit) {
+		for (auto xit = row.begin(); xit != row.end(); ++xit) {
 			size_t distance = dijkstra_distance(map, dist, {x, y});
 			if (distance < INT_MAX) {
 				std::cout << std::setw(x_width) << dijkstra_distance(map, dist, {x, y});
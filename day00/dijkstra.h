@@ -2,28 +2,258 @@
 #if !defined(DIJKSTRA_H)
 #define DIJKSTRA_H
 
+#include <array>	 // charmap_graph_t directions
+#include <climits>	 // INT_MAX
+#include <cstdint>	 // uint32_t
 #include <map>
 #include <vector>
 
 #include "charmap.h"
+#include "graph.h"
 #include "point.h"
 #include "vector.h"
 
+struct thread_pool_t;
+
 // dijkstra types, code below
 using dist_t = std::map<vector_t, size_t>;
 using pred_t = std::map<vector_t, std::vector<vector_t>>;
 
+// The cost of going from current to neighbor, when it has cost so far
+using cost_fn_t = size_t (*)(const size_t cost,
+							 const vector_t& current, const vector_t& neighbor,
+							 const charmap_t& map);
+
 // Returns, min_cost, dist[], pred[]
 std::tuple<size_t, dist_t, pred_t> dijkstra(
 	const charmap_t& map,
 	const vector_t& start,
 	const point_t& end,
-	size_t (*cost_fn)(const size_t cost,
-					  const vector_t& current, const vector_t& neighbor,
-					  const charmap_t& map) = nullptr);
+	cost_fn_t cost_fn = nullptr);
 
 size_t dijkstra_distance(const charmap_t& map, const dist_t& dist, const point_t& p);
 std::vector<point_t> dijkstra_path(const point_t& end, const pred_t& pred);
 void show_dijkstra_distances(const charmap_t& map, const dist_t& dist);
 
+/* What grid_dijkstra() found. A state is a cell and the direction it was
+ * entered from, (y * size_x + x) * 4 + direction, with direction an index
+ * into {0,1}, {1,0}, {0,-1}, {-1,0}; dist and parent are flat arrays of them.
+ * Each source whose dir is none of those (e.g. {0,0}) gets one extra state
+ * after the grid's, in the order they were given.
+ */
+struct grid_dist_t {
+	static constexpr size_t unreached = ~size_t{0};
+	static constexpr uint32_t no_parent = ~uint32_t{0};
+
+	size_t min_cost = INT_MAX;	// to end, INT_MAX if it was not reached
+	dimension_t size_x = 0;
+	dimension_t size_y = 0;
+	std::vector<vector_t> undirected = {};	 // sources with the extra states
+	std::vector<size_t> dist = {};			 // cost of each state, or unreached
+	std::vector<uint32_t> parent = {};		 // state it was reached from
+	size_t expanded = 0;					 // states taken off the queue and expanded
+
+	grid_dist_t() {
+	}
+
+	// every state unreached
+	grid_dist_t(const charmap_t& map, const std::vector<vector_t>& sources);
+
+	size_t state(const vector_t& v) const;
+	vector_t vertex(size_t state) const;
+
+	// cheapest way into p from any direction, unreached if none
+	size_t distance(const point_t& p) const;
+
+	// one cheapest path, source to end, empty if end was not reached
+	std::vector<point_t> path(const point_t& end) const;
+};
+
+/* dijkstra() for grids: the same moves and costs, with dist and parent in
+ * flat arrays rather than maps, and a bucket_queue_t (Dial's algorithm) that
+ * expects no step to cost more than max_weight (9 for the digit maps
+ * default_cost reads). A heavier step is fine, the queue turns into a radix
+ * heap from then on. Unlike dijkstra() only one parent of each state is
+ * kept.
+ */
+grid_dist_t grid_dijkstra(
+	const charmap_t& map,
+	const vector_t& start,
+	const point_t& end,
+	cost_fn_t cost_fn = nullptr,
+	size_t max_weight = 9);
+
+/* From the nearest of several sources, all at cost 0: dist is the cost from
+ * whichever is cheapest and following parent leads back to it. An end off
+ * the map (e.g. {-1, -1}) fills in dist for everything reachable.
+ */
+grid_dist_t grid_dijkstra(
+	const charmap_t& map,
+	const std::vector<vector_t>& sources,
+	const point_t& end,
+	cost_fn_t cost_fn = nullptr,
+	size_t max_weight = 9);
+
+// A lower bound on the cost from p to end
+using heuristic_fn_t = size_t (*)(const point_t& p, const point_t& end);
+
+/* grid_dijkstra() steered toward end: states are taken in order of cost so
+ * far + heuristic(p, end), so ones heading away from end are left on the
+ * queue. heuristic must be admissible (never over the real cost) for the
+ * cost found to be the cheapest. The default is the manhattan_distance() to
+ * end, which is admissible as long as every step costs at least 1; on a map
+ * with '0's it can overestimate, so use one that is scaled down there, or
+ * grid_dijkstra().
+ *
+ * A heuristic that is also consistent (never drops by more than a step
+ * costs) has each state expanded once. One that is not still works: a
+ * state's key is never put below the key of the state it was reached from
+ * (pathmax), so the bucket queue stays in order, and a state that is
+ * reached cheaper after it was expanded is expanded again.
+ *
+ * dist and parent are filled in the same way, only for fewer states;
+ * compare expanded with grid_dijkstra() to see how many fewer.
+ */
+grid_dist_t grid_astar(
+	const charmap_t& map,
+	const vector_t& start,
+	const point_t& end,
+	cost_fn_t cost_fn = nullptr,
+	heuristic_fn_t heuristic = nullptr,
+	size_t max_weight = 9);
+
+grid_dist_t grid_astar(
+	const charmap_t& map,
+	const std::vector<vector_t>& sources,
+	const point_t& end,
+	cost_fn_t cost_fn = nullptr,
+	heuristic_fn_t heuristic = nullptr,
+	size_t max_weight = 9);
+
+// What grid_bidirectional() found
+struct grid_path_t {
+	size_t min_cost = INT_MAX;		 // INT_MAX if end can not be reached
+	size_t expanded = 0;			 // by both searches
+	std::vector<point_t> path = {};	 // one cheapest path, source to end
+};
+
+/* grid_dijkstra() from the sources and, at the same time, backwards from
+ * end, one state from each in turn, until they meet. On a long query each
+ * only gets about half way, so between them they expand around half the
+ * states one search would.
+ *
+ * They meet on a state, a cell and the direction it was entered in, not on
+ * just a cell: with a cost_fn that charges for turning, arriving at a cell
+ * going one way and leaving it going another is not free. Every state both
+ * have reached gives a cost, the best is kept, and the search stops once
+ * the costs each side is expanding at add up to no less than it.
+ *
+ * Going backwards needs the cost of a step on its own, which is taken as
+ * cost_fn(0, ...), so cost_fn must add the same for a step whatever the cost
+ * so far is (default_cost does).
+ */
+grid_path_t grid_bidirectional(
+	const charmap_t& map,
+	const std::vector<vector_t>& sources,
+	const point_t& end,
+	cost_fn_t cost_fn = nullptr,
+	size_t max_weight = 9);
+
+/* grid_dijkstra() on all the threads of pool, for maps of millions of cells
+ * (delta-stepping). States are put in buckets delta of cost wide rather than
+ * in strict order. The states in the lowest bucket are expanded together,
+ * in parallel, along their light steps (cost <= delta), which can drop
+ * states back into the same bucket, until it is empty; then the heavy steps
+ * of everything that was in it are taken, also in parallel. A larger delta
+ * gives more to do in parallel per round and more states expanded more than
+ * once.
+ *
+ * Each state's cost and parent are one 64 bit word, updated with a compare
+ * and swap only when the cost goes down, so whichever thread wins, the
+ * parent always matches the cost, and the parents form a tree.
+ *
+ * min_cost is the one grid_dijkstra() finds, and so is every dist below it:
+ * those are final in both. When the search stops at end, the entries from
+ * min_cost up are only tentative and differ, as delta-stepping finishes the
+ * whole bucket end is in and its heavy steps. With end off the map both run
+ * to the end and all of dist matches. parent may be another path of the
+ * same cost. Costs must fit in 32 bits and cost_fn must be safe to call from
+ * many threads at once.
+ */
+grid_dist_t grid_delta_stepping(
+	const charmap_t& map,
+	const std::vector<vector_t>& sources,
+	const point_t& end,
+	thread_pool_t& pool,
+	cost_fn_t cost_fn = nullptr,
+	size_t delta = 9);
+
+// charmap_graph_t cost: the digit stepped onto, what default_cost charges
+struct digit_cost_t {
+	size_t operator()(const charmap_t& map, const vector_t&, const vector_t& neighbor) const {
+		return static_cast<size_t>(map.get(neighbor.p) - '0');
+	}
+};
+
+/* A charmap_t as a graph_c for graph_dijkstra(), with the states of
+ * grid_dist_t: vertex (y * size_x + x) * 4 + direction is the cell entered
+ * going that way, and its neighbours are the 4 cells around it. Cost is a
+ * callable cost(map, current, neighbor) giving the weight of a step, inlined
+ * where a cost_fn_t is called through a pointer. Unlike grid_dijkstra()
+ * there are no extra states, so sources need one of the 4 directions.
+ *
+ *	charmap_graph_t graph(map);
+ *	auto found = graph_dijkstra(graph, {graph.state(start)}, graph.at(end));
+ */
+template <typename Cost = digit_cost_t>
+struct charmap_graph_t {
+	static constexpr std::array<point_t, 4> directions = {{{0, 1}, {1, 0}, {0, -1}, {-1, 0}}};
+
+	const charmap_t& map;
+	Cost cost;
+
+	explicit charmap_graph_t(const charmap_t& map, Cost cost = {}) : map(map), cost(cost) {
+	}
+
+	size_t size() const {
+		return static_cast<size_t>(this->map.size_x * this->map.size_y) * directions.size();
+	}
+
+	size_t state(const vector_t& v) const {
+		size_t d = 0;
+		while (d < directions.size() && directions[d] != v.dir) {
+			d++;
+		}
+		assert(d < directions.size());
+		return static_cast<size_t>(v.p.y * this->map.size_x + v.p.x) * directions.size() + d;
+	}
+
+	vector_t vertex(size_t state) const {
+		dimension_t cell = static_cast<dimension_t>(state / directions.size());
+		return {point_t(cell % this->map.size_x, cell / this->map.size_x), directions[state % directions.size()]};
+	}
+
+	// target for graph_dijkstra(): any state at p
+	auto at(const point_t& p) const {
+		const size_t cell = static_cast<size_t>(p.y * this->map.size_x + p.x);
+		return [cell](size_t state) { return state / directions.size() == cell; };
+	}
+
+	neighbour_list_t<4> neighbours(size_t u) const {
+		neighbour_list_t<4> list;
+		const point_t p = this->vertex(u).p;
+		for (size_t d = 0; d < directions.size(); d++) {
+			const point_t next = p + directions[d];
+			if (this->map.is_valid(next)) {
+				list.push_back(static_cast<size_t>(next.y * this->map.size_x + next.x) * directions.size() + d);
+			}
+		}
+		return list;
+	}
+
+	size_t weight(size_t u, size_t v) const {
+		return this->cost(this->map, this->vertex(u), this->vertex(v));
+	}
+};
+
 #endif
@@ -0,0 +1,157 @@
+#if !defined(MORTON_H)
+#define MORTON_H
+
+#include <algorithm>  // sort, unique, lower_bound
+#include <cstdint>	  // uint64_t
+#include <ranges>	  // views::transform
+#include <vector>	  // std::vector
+
+#include "point.h"
+
+/* Morton (Z-order) code of a point, x,y,z,w bits interleaved.
+ * Each coordinate gets 16 bits, biased so -32768..32767 all fit; a point
+ * with any coordinate outside morton_min .. morton_max would wrap onto
+ * another, and morton_encode() asserts it does not.
+ * Points that are close in space end up close in key order.
+ */
+using morton_t = uint64_t;
+
+constexpr dimension_t morton_min = -32768;
+constexpr dimension_t morton_max = 32767;
+
+extern morton_t morton_encode(const point_t& p);
+extern point_t morton_decode(const morton_t key);
+
+/* Set of points kept as a sorted vector of Morton keys.
+ * Lookups are binary searches and iteration runs in Z-order, so walking the
+ * set and probing neighbors stays in nearby memory instead of hopping between
+ * hash buckets. Built for cellular automata (day17, day24) where each
+ * generation is made in bulk, see next_generation().
+ */
+struct morton_set_t {
+	std::vector<morton_t> keys = {};  // sorted, unique
+
+	morton_set_t() {
+	}
+
+	template <typename T>
+	static morton_set_t from_points(const T& points) {
+		morton_set_t set;
+		set.merge(points);
+		return set;
+	}
+
+	size_t size() const {
+		return keys.size();
+	}
+
+	bool empty() const {
+		return keys.empty();
+	}
+
+	bool contains(const point_t& p) const {
+		return std::binary_search(keys.begin(), keys.end(), morton_encode(p));
+	}
+
+	/* Insert one point, O(n); use merge() to add many at once. */
+	void insert(const point_t& p) {
+		morton_t key = morton_encode(p);
+		auto it = std::lower_bound(keys.begin(), keys.end(), key);
+		if (it == keys.end() || *it != key) {
+			keys.insert(it, key);
+		}
+	}
+
+	void erase(const point_t& p) {
+		morton_t key = morton_encode(p);
+		auto it = std::lower_bound(keys.begin(), keys.end(), key);
+		if (it != keys.end() && *it == key) {
+			keys.erase(it);
+		}
+	}
+
+	/* Bulk insert any iterable of point_t; one sort for the lot. */
+	template <typename T>
+	void merge(const T& points) {
+		auto middle = static_cast<std::ptrdiff_t>(keys.size());
+		for (const auto& p : points) {
+			keys.push_back(morton_encode(p));
+		}
+
+		std::sort(keys.begin() + middle, keys.end());
+		std::inplace_merge(keys.begin(), keys.begin() + middle, keys.end());
+		keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+	}
+
+	void merge(const morton_set_t& other) {
+		std::vector<morton_t> merged;
+		merged.reserve(keys.size() + other.keys.size());
+		std::set_union(keys.begin(), keys.end(),
+					   other.keys.begin(), other.keys.end(),
+					   std::back_inserter(merged));
+		keys.swap(merged);
+	}
+
+	/* Number of points in the set at p + each of offsets. */
+	size_t count_neighbors(const point_t& p, const std::vector<point_t>& offsets) const {
+		size_t count = 0;
+		for (const auto& offset : offsets) {
+			if (this->contains(p + offset)) {
+				count++;
+			}
+		}
+		return count;
+	}
+
+	/* Return the next generation of a cellular automaton.
+	 * Every live cell spreads a key to each of its `offsets`, the keys are
+	 * sorted so each run length is a neighbor count, then a single merge walk
+	 * with the live keys calls rule(is_alive, neighbors) for every candidate.
+	 *
+	 *	auto next = current.next_generation(offsets, [](bool alive, size_t n) {
+	 *		return n == 3 || (alive && n == 2);
+	 *	});
+	 */
+	template <typename Rule>
+	morton_set_t next_generation(const std::vector<point_t>& offsets, Rule rule) const {
+		std::vector<morton_t> spread;
+		spread.reserve(keys.size() * offsets.size());
+		for (const auto key : keys) {
+			point_t p = morton_decode(key);
+			for (const auto& offset : offsets) {
+				spread.push_back(morton_encode(p + offset));
+			}
+		}
+		std::sort(spread.begin(), spread.end());
+
+		morton_set_t next;
+		auto live = keys.begin();
+		auto it = spread.begin();
+		while (it != spread.end() || live != keys.end()) {
+			morton_t key = (it == spread.end() || (live != keys.end() && *live < *it)) ? *live : *it;
+
+			size_t neighbors = 0;
+			for (; it != spread.end() && *it == key; ++it) {
+				neighbors++;
+			}
+
+			bool alive = live != keys.end() && *live == key;
+			if (alive) {
+				++live;
+			}
+
+			if (rule(alive, neighbors)) {
+				next.keys.push_back(key);
+			}
+		}
+
+		return next;
+	}
+
+	// std::views iterator for all points, in Z-order
+	auto points() const {
+		return keys | std::views::transform(morton_decode);
+	}
+};
+
+#endif
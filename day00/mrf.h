@@ -1,13 +1,48 @@
-/* map(), reduce(), and filter() meta-functions */
-#include <algorithm>  // sort
-#include <functional>
-#include <ranges>  // ranges and views
-#include <vector>  // collection
+/* map(), reduce(), and filter() meta-functions, and lazy pipelines
+ *
+ * They take any input range (vector, set, views, ...) by reference, and the
+ * function as a template parameter rather than a std::function, so the call
+ * can be inlined and the loop vectorized. The element and result types can
+ * still be given explicitly, e.g. reduce<string, size_t>(...), but they are
+ * deduced when left off.
+ *
+ * Where the library has execution policies there are also overloads that
+ * take one first, e.g. std::execution::par_unseq, to run across cores.
+ * (libstdc++ needs -ltbb for those, libc++ does not have them yet.)
+ *
+ * map() and filter() build a vector each, so chaining them copies the data
+ * once per step. The pipeline form at the bottom fuses the steps into one
+ * loop over the source with no vectors in between:
+ *
+ *	auto total = from(groups) | map(unique_answers_count) | sum();
+ */
+#include <algorithm>	 // sort
+#include <functional>	 // invoke, plus
+#include <iterator>		 // back_inserter
+#include <numeric>		 // transform_reduce
+#include <optional>		 // min/max of maybe empty pipeline
+#include <ranges>		 // ranges and views
+#include <thread>		 // par() pipelines
+#include <type_traits>	 // invoke_result_t
+#include <utility>		 // move, pair
+#include <vector>		 // collection
 
-/* Reduce vector of U to single T using func */
-template <typename T, typename R>
-R reduce(const std::vector<T> vec, const R start, std::function<R(T, R)> func) {
-	return std::accumulate(vec.begin(), vec.end(), start, func);
+#if __has_include(<execution>)
+#include <execution>	// execution policies
+#endif
+
+/* Element type check for the optional explicit element type T */
+template <typename T, typename Range>
+concept mrf_element_of = std::is_void_v<T> || std::convertible_to<std::ranges::range_reference_t<Range>, T>;
+
+/* Reduce range of T to single R using func(accum, element) */
+template <typename T = void, typename R, std::ranges::input_range Range, typename F>
+	requires mrf_element_of<T, Range>
+R reduce(Range&& range, R start, F&& func) {
+	for (auto&& element : range) {
+		start = std::invoke(func, std::move(start), element);
+	}
+	return start;
 }
 
 /* Example using reduce()
@@ -16,20 +51,29 @@ R reduce(const std::vector<T> vec, const R start, std::function<R(T, R)> func) {
  *
  * Make a function that adds the value of pass to accum
  *
- *	size_t add_pass(const size_t accum, const string &pass) { return accum + ...; }
+ *	size_t add_pass(size_t accum, const string &pass) { return accum + ...; }
  *
- * The use the reduce passing the function, make sure to include the types!
+ * The use the reduce passing the function, the types can be left off.
  *
- *	auto total = reduce<string, size_t>(passes, 0, add_pass);
+ *	auto total = reduce<string, size_t>(passes, 0ul, add_pass);
+ *	auto total = reduce(passes, 0ul, add_pass);
  */
 
-/* Map vector of S to vector of D using func */
-template <typename T, typename R>
-std::vector<R> map(const std::vector<T>& src,
-				   const std::function<R(const T&)> func) {
-	std::vector<R> dst;
-	dst.reserve(src.size());
-	std::transform(src.begin(), src.end(), std::back_inserter(dst), func);
+/* Map range of T to vector of R using func */
+template <typename T = void, typename R = void, std::ranges::input_range Range, typename F>
+	requires mrf_element_of<T, Range>
+auto map(Range&& src, F&& func) {
+	using mapped_t = std::conditional_t<std::is_void_v<R>,
+										std::remove_cvref_t<std::invoke_result_t<F&, std::ranges::range_reference_t<Range>>>,
+										R>;
+	std::vector<mapped_t> dst;
+	if constexpr (std::ranges::sized_range<Range>) {
+		dst.reserve(std::ranges::size(src));
+	}
+
+	for (auto&& element : src) {
+		dst.push_back(std::invoke(func, element));
+	}
 	return dst;
 }
 
@@ -39,17 +83,22 @@ std::vector<R> map(const std::vector<T>& src,
  *
  *	size_t decode_pass(const string &pass) { return 0; }
  *
- * The use the map passing the function, make sure to include the types!
+ * The use the map passing the function, the types can be left off.
  *
  *	auto seats = map<string, size_t>(passes, decode_pass);
+ *	auto seats = map(passes, decode_pass);
  */
 
-/* filter vector to a new vector for all that match func. */
-template <typename T>
-std::vector<T> filter(const std::vector<T> src,
-					  const std::function<bool(const T&)> func) {
-	std::vector<T> filtered;
-	std::copy_if(src.begin(), src.end(), std::back_inserter(filtered), func);
+/* filter range to a new vector for all that match func. */
+template <typename T = void, std::ranges::input_range Range, typename F>
+	requires mrf_element_of<T, Range>
+auto filter(Range&& src, F&& func) {
+	std::vector<std::ranges::range_value_t<Range>> filtered;
+	for (auto&& element : src) {
+		if (std::invoke(func, element)) {
+			filtered.push_back(element);
+		}
+	}
 	return filtered;
 }
 
@@ -60,6 +109,263 @@ std::vector<T> filter(const std::vector<T> src,
  *	});
  */
 
+#if defined(__cpp_lib_execution)
+template <typename Policy>
+concept mrf_execution_policy = std::is_execution_policy_v<std::remove_cvref_t<Policy>>;
+
+/* Parallel reduce, elements may be visited in any order and on any thread.
+ * So rather than one func(accum, element), give transform(element) -> R and
+ * combine(R, R) -> R, where combine is associative and commutative.
+ *
+ *	auto total = reduce(std::execution::par_unseq, passes, 0ul, std::plus<>(), pass_value);
+ */
+template <mrf_execution_policy Policy, std::ranges::random_access_range Range,
+		  typename R, typename Combine, typename Transform>
+	requires std::ranges::common_range<Range>
+R reduce(Policy&& policy, Range&& range, R start, Combine&& combine, Transform&& transform) {
+	return std::transform_reduce(std::forward<Policy>(policy),
+								 std::ranges::begin(range), std::ranges::end(range),
+								 std::move(start), combine, transform);
+}
+
+/* Parallel map, func must be safe to call from many threads at once */
+template <mrf_execution_policy Policy, std::ranges::random_access_range Range, typename F>
+	requires std::ranges::common_range<Range> && std::ranges::sized_range<Range>
+auto map(Policy&& policy, Range&& src, F&& func) {
+	using mapped_t = std::remove_cvref_t<std::invoke_result_t<F&, std::ranges::range_reference_t<Range>>>;
+	std::vector<mapped_t> dst(std::ranges::size(src));
+	std::transform(std::forward<Policy>(policy),
+				   std::ranges::begin(src), std::ranges::end(src), dst.begin(), func);
+	return dst;
+}
+
+/* Parallel filter, keeps the order of the input */
+template <mrf_execution_policy Policy, std::ranges::random_access_range Range, typename F>
+	requires std::ranges::common_range<Range> && std::ranges::sized_range<Range>
+auto filter(Policy&& policy, Range&& src, F&& func) {
+	std::vector<std::ranges::range_value_t<Range>> filtered(std::ranges::size(src));
+	auto last = std::copy_if(std::forward<Policy>(policy),
+							 std::ranges::begin(src), std::ranges::end(src), filtered.begin(), func);
+	filtered.erase(last, filtered.end());
+	return filtered;
+}
+#endif
+
+/* Lazy pipelines
+ *
+ * from(range) starts a pipeline, map(f) and filter(p) add steps, and a
+ * terminal (sum, count, min, max, fold, to_vector) runs it. Nothing happens
+ * until the terminal: the steps are folded into a single callable that is
+ * handed each source element in turn, so the compiler sees one loop.
+ *
+ *	auto largest = from(passes) | map(decode_pass) | max();
+ *	auto odd = from(numbers) | filter([](int n) { return n & 1; }) | to_vector();
+ *
+ * Wrap the terminal in par() to split the source into one chunk per core,
+ * run each chunk on its own thread, and combine the partial results in
+ * order. The source must be random access and sized, and the steps safe to
+ * call from several threads at once.
+ *
+ *	auto total = from(tickets) | map(error_rate) | par(sum());
+ */
+
+/* A source range and the steps so far. E is the type the steps produce,
+ * chain(sink) returns a callable that takes a source element, runs it
+ * through the steps, and passes any result on to sink.
+ */
+template <typename Range, typename E, typename Chain>
+struct pipeline_t {
+	Range range;
+	Chain chain;
+};
+
+template <std::ranges::input_range Range>
+auto from(Range&& range) {
+	using element_t = std::remove_cvref_t<std::ranges::range_reference_t<Range>>;
+	auto chain = [](auto sink) { return sink; };
+	return pipeline_t<Range, element_t, decltype(chain)>{std::forward<Range>(range), chain};
+}
+
+template <typename F>
+struct map_step_t {
+	F func;
+};
+
+template <typename F>
+struct filter_step_t {
+	F func;
+};
+
+/* map(f) and filter(p) with just the callable are pipeline steps */
+template <typename F>
+	requires(!std::ranges::input_range<F>)
+map_step_t<std::decay_t<F>> map(F&& func) {
+	return {std::forward<F>(func)};
+}
+
+template <typename F>
+	requires(!std::ranges::input_range<F>)
+filter_step_t<std::decay_t<F>> filter(F&& func) {
+	return {std::forward<F>(func)};
+}
+
+template <typename Range, typename E, typename Chain, typename F>
+auto operator|(pipeline_t<Range, E, Chain> pipeline, map_step_t<F> step) {
+	using mapped_t = std::remove_cvref_t<std::invoke_result_t<F&, const E&>>;
+	auto chain = [prev = std::move(pipeline.chain), func = std::move(step.func)](auto sink) {
+		return prev([sink, func](const E& element) mutable { sink(std::invoke(func, element)); });
+	};
+	return pipeline_t<Range, mapped_t, decltype(chain)>{std::forward<Range>(pipeline.range), std::move(chain)};
+}
+
+template <typename Range, typename E, typename Chain, typename F>
+auto operator|(pipeline_t<Range, E, Chain> pipeline, filter_step_t<F> step) {
+	auto chain = [prev = std::move(pipeline.chain), func = std::move(step.func)](auto sink) {
+		return prev([sink, func](const E& element) mutable {
+			if (std::invoke(func, element)) {
+				sink(element);
+			}
+		});
+	};
+	return pipeline_t<Range, E, decltype(chain)>{std::forward<Range>(pipeline.range), std::move(chain)};
+}
+
+/* Terminals: init<E>() makes an empty state, add() folds one element in,
+ * combine() joins the states of two chunks (left then right) for par(),
+ * and finish() turns the state into the result.
+ */
+struct sum_t {
+	template <typename E> E init() const { return E{}; }
+	template <typename E> void add(E& total, const E& element) const { total += element; }
+	template <typename E> void combine(E& total, E&& other) const { total += other; }
+	template <typename E> E finish(E&& total) const { return total; }
+};
+
+struct count_t {
+	template <typename E> size_t init() const { return 0; }
+	template <typename E> void add(size_t& total, const E&) const { total++; }
+	void combine(size_t& total, size_t other) const { total += other; }
+	size_t finish(size_t total) const { return total; }
+};
+
+/* min() and max() of an empty pipeline are E{} */
+template <typename Less>
+struct extreme_t {
+	Less less;
+
+	template <typename E> std::optional<E> init() const { return std::nullopt; }
+	template <typename E> void add(std::optional<E>& best, const E& element) const {
+		if (!best || std::invoke(less, *best, element)) {
+			best = element;
+		}
+	}
+	template <typename E> void combine(std::optional<E>& best, std::optional<E>&& other) const {
+		if (other) {
+			add(best, *other);
+		}
+	}
+	template <typename E> E finish(std::optional<E>&& best) const { return best.value_or(E{}); }
+};
+
+/* fold(start, func) is reduce() for pipelines, combine is only needed for par() */
+template <typename R, typename F, typename Combine>
+struct fold_t {
+	R start;
+	F func;
+	Combine join;
+
+	template <typename E> R init() const { return start; }
+	template <typename E> void add(R& accum, const E& element) const { accum = std::invoke(func, std::move(accum), element); }
+	void combine(R& accum, R&& other) const { accum = std::invoke(join, std::move(accum), std::move(other)); }
+	R finish(R&& accum) const { return std::move(accum); }
+};
+
+struct to_vector_t {
+	template <typename E> std::vector<E> init() const { return {}; }
+	template <typename E> void add(std::vector<E>& dst, const E& element) const { dst.push_back(element); }
+	template <typename E> void combine(std::vector<E>& dst, std::vector<E>&& other) const {
+		dst.insert(dst.end(), std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+	}
+	template <typename E> std::vector<E> finish(std::vector<E>&& dst) const { return std::move(dst); }
+};
+
+inline sum_t sum() { return {}; }
+inline count_t count() { return {}; }
+inline extreme_t<std::greater<>> min() { return {}; }
+inline extreme_t<std::less<>> max() { return {}; }
+inline to_vector_t to_vector() { return {}; }
+
+template <typename R, typename F, typename Combine = std::plus<>>
+fold_t<R, std::decay_t<F>, Combine> fold(R start, F&& func, Combine join = {}) {
+	return {std::move(start), std::forward<F>(func), std::move(join)};
+}
+
+template <typename Terminal>
+concept mrf_terminal = requires(const Terminal& terminal) { terminal.template init<int>(); };
+
+/* Run the steps over [first, last) into a fresh state of the terminal */
+template <typename E, typename Chain, typename Terminal, typename It, typename Sentinel>
+auto run_pipeline(const Chain& chain, const Terminal& terminal, It first, Sentinel last) {
+	auto state = terminal.template init<E>();
+	auto consume = chain([&state, &terminal](const E& element) { terminal.add(state, element); });
+	for (; first != last; ++first) {
+		consume(*first);
+	}
+	return state;
+}
+
+template <typename Range, typename E, typename Chain, mrf_terminal Terminal>
+auto operator|(pipeline_t<Range, E, Chain> pipeline, const Terminal& terminal) {
+	return terminal.finish(run_pipeline<E>(pipeline.chain, terminal,
+										   std::ranges::begin(pipeline.range), std::ranges::end(pipeline.range)));
+}
+
+/* par(terminal) runs the pipeline on up to threads threads (0 = one per core) */
+template <mrf_terminal Terminal>
+struct par_t {
+	Terminal terminal;
+	size_t threads;
+};
+
+template <mrf_terminal Terminal>
+par_t<Terminal> par(Terminal terminal, size_t threads = 0) {
+	return {std::move(terminal), threads};
+}
+
+template <typename Range, typename E, typename Chain, typename Terminal>
+	requires std::ranges::random_access_range<Range> && std::ranges::sized_range<Range>
+auto operator|(pipeline_t<Range, E, Chain> pipeline, const par_t<Terminal>& par) {
+	/* below this many elements per thread the threads cost more than they save */
+	constexpr size_t min_chunk = 1024;
+
+	const auto& terminal = par.terminal;
+	const size_t size = std::ranges::size(pipeline.range);
+	size_t threads = par.threads ? par.threads : std::max(1u, std::thread::hardware_concurrency());
+	threads = std::max(size_t{1}, std::min(threads, size / min_chunk));
+
+	auto first = std::ranges::begin(pipeline.range);
+	auto chunk_begin = [&](size_t i) {
+		return first + static_cast<std::ranges::range_difference_t<Range>>(size * i / threads);
+	};
+
+	using state_t = decltype(terminal.template init<E>());
+	std::vector<state_t> states(threads, terminal.template init<E>());
+	{
+		std::vector<std::jthread> workers;
+		workers.reserve(threads - 1);
+		for (size_t i = 1; i < threads; i++) {
+			workers.emplace_back([&, i] {
+				states[i] = run_pipeline<E>(pipeline.chain, terminal, chunk_begin(i), chunk_begin(i + 1));
+			});
+		}
+		states[0] = run_pipeline<E>(pipeline.chain, terminal, chunk_begin(0), chunk_begin(1));
+	}
+	for (size_t i = 1; i < threads; i++) {
+		terminal.combine(states[0], std::move(states[i]));
+	}
+	return terminal.finish(std::move(states[0]));
+}
+
 /* Enumerate the vector V resulting in a vector of pairs (index, value)
  * 	using I as index type and V as value type
  */
@@ -80,4 +386,4 @@ std::vector<std::pair<I, V>> enumerate(const std::vector<V>& vec) {
 
 	Now e will be a vector of pairs:
 		[ {0, 1}, {1, 2}, {2, 3} ]
-*/
\ No newline at end of file
+*/
@@ -0,0 +1,223 @@
+#if !defined(RLE_CHARMAP_T_H)
+#define RLE_CHARMAP_T_H
+
+#include <algorithm>  // sort, unique, upper_bound, fill
+#include <cstddef>	// size_t
+#include <iterator>	// prev
+#include <ranges>	// rows
+#include <span>		// row runs
+#include <string>	// row_string
+#include <utility>	// pair
+#include <vector>	// std::vector
+
+#include "charmap.h"
+#include "point.h"
+
+/* charmap_t for big maps that are mostly filler ('.'), kept as runs.
+ *
+ * Only cells that are not filler are stored, as runs of one char along a
+ * row, and only rows that have some are indexed. The memory is a few words
+ * per run, however big size_x * size_y is, so a map built from_points() of
+ * a spread out set can be held and scanned when the dense charmap_t would
+ * not fit. get() is two binary searches, rows are scanned a run at a time.
+ *
+ *	rle_charmap_t map = rle_charmap_t::from_points(active);
+ *	for (const auto& [y, runs] : map.rows()) {
+ *		for (const auto& run : runs) {
+ *			... run.x, run.length, run.ch
+ *		}
+ *	}
+ */
+struct rle_charmap_t {
+	struct run_t {
+		dimension_t x;
+		dimension_t length;
+		char ch;
+
+		dimension_t end() const {
+			return this->x + this->length;
+		}
+	};
+
+	dimension_t size_x = 0;
+	dimension_t size_y = 0;
+	char filler = '.';
+	std::vector<run_t> runs = {};			 // row by row, left to right
+	std::vector<dimension_t> row_y = {};	 // the rows with runs, in order
+	std::vector<size_t> row_first = {0};	 // runs of row_y[i] start at row_first[i]
+
+	rle_charmap_t() {
+	}
+
+	// all filler, size_x x size_y
+	template <std::convertible_to<dimension_t> Tx, std::convertible_to<dimension_t> Ty>
+	rle_charmap_t(Tx size_x, Ty size_y, char filler = '.')
+		: size_x(static_cast<dimension_t>(size_x)), size_y(static_cast<dimension_t>(size_y)), filler(filler) {
+	}
+
+	static rle_charmap_t from_charmap(const charmap_t& map, const char filler = '.') {
+		rle_charmap_t rle(map.size_x, map.size_y, filler);
+		for (dimension_t y = 0; y < map.size_y; y++) {
+			auto row = map.row(y);
+			for (size_t x = 0; x < row.size();) {
+				size_t end = x + 1;
+				while (end < row.size() && row[end] == row[x]) {
+					end++;
+				}
+				if (row[x] != filler) {
+					rle.add_run(y, static_cast<dimension_t>(x), static_cast<dimension_t>(end - x), row[x]);
+				}
+				x = end;
+			}
+		}
+		return rle;
+	}
+
+	/* Like charmap_t::from_points(), but shifted so the bounding box starts
+	 * at 0, 0 and without ever making the dense map.
+	 */
+	template <typename T>
+	static rle_charmap_t from_points(const T& points, const char marker = '#', const char filler = '.') {
+		std::vector<std::pair<dimension_t, dimension_t>> cells;	 // y, x
+		for (const auto& p : points) {
+			cells.emplace_back(p.y, p.x);
+		}
+		if (cells.empty()) {
+			return rle_charmap_t(0, 0, filler);
+		}
+		std::sort(cells.begin(), cells.end());
+		cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+
+		dimension_t min_x = cells.front().second;
+		dimension_t max_x = cells.front().second;
+		for (const auto& [y, x] : cells) {
+			min_x = std::min(min_x, x);
+			max_x = std::max(max_x, x);
+		}
+		dimension_t min_y = cells.front().first;
+		dimension_t max_y = cells.back().first;
+
+		rle_charmap_t rle(max_x - min_x + 1, max_y - min_y + 1, filler);
+		for (size_t i = 0; i < cells.size();) {
+			// a run is neighbouring x on the same y
+			size_t end = i + 1;
+			while (end < cells.size() && cells[end].first == cells[i].first
+				   && cells[end].second == cells[end - 1].second + 1) {
+				end++;
+			}
+			rle.add_run(cells[i].first - min_y, cells[i].second - min_x, static_cast<dimension_t>(end - i), marker);
+			i = end;
+		}
+		return rle;
+	}
+
+	template <std::convertible_to<dimension_t> Tx, std::convertible_to<dimension_t> Ty>
+	bool is_valid(const Tx x, const Ty y) const {
+		dimension_t native_x = static_cast<dimension_t>(x);
+		dimension_t native_y = static_cast<dimension_t>(y);
+		return 0 <= native_x && native_x < this->size_x && 0 <= native_y && native_y < this->size_y;
+	}
+
+	bool is_valid(const point_t& p) const {
+		return is_valid(p.x, p.y);
+	}
+
+	template <std::convertible_to<dimension_t> Tx, std::convertible_to<dimension_t> Ty>
+	char get(const Tx x, const Ty y, const char invalid = '\0') const {
+		if (!this->is_valid(x, y)) {
+			return invalid;
+		}
+
+		// the last run starting at or before x
+		auto runs = this->row_runs(y);
+		auto after = std::upper_bound(runs.begin(), runs.end(), static_cast<dimension_t>(x),
+									  [](dimension_t at, const run_t& run) { return at < run.x; });
+		if (after != runs.begin() && static_cast<dimension_t>(x) < std::prev(after)->end()) {
+			return std::prev(after)->ch;
+		}
+		return this->filler;
+	}
+
+	char get(const point_t& p, const char invalid = '\0') const {
+		return this->get(p.x, p.y, invalid);
+	}
+
+	bool is_char(const point_t& p, const char c) const {
+		return this->get(p) == c;
+	}
+
+	/* The runs of row y, empty if it is all filler */
+	template <std::convertible_to<dimension_t> Ty>
+	std::span<const run_t> row_runs(const Ty y) const {
+		auto at = std::lower_bound(this->row_y.begin(), this->row_y.end(), static_cast<dimension_t>(y));
+		if (at == this->row_y.end() || *at != static_cast<dimension_t>(y)) {
+			return {};
+		}
+		return this->runs_of(static_cast<size_t>(at - this->row_y.begin()));
+	}
+
+	// std::views iterator over the rows with runs as pair<y, span<const run_t>>
+	auto rows() const {
+		return std::views::iota(size_t{0}, this->row_y.size()) | std::views::transform([this](size_t i) {
+				   return std::pair<dimension_t, std::span<const run_t>>(this->row_y[i], this->runs_of(i));
+			   });
+	}
+
+	charmap_t to_charmap() const {
+		charmap_t map(this->size_x, this->size_y, this->filler);
+		for (const auto& [y, runs] : this->rows()) {
+			auto row = map.row(y);
+			for (const auto& run : runs) {
+				std::fill(row.begin() + run.x, row.begin() + run.end(), run.ch);
+			}
+		}
+		return map;
+	}
+
+	/* Row y as size_x chars */
+	template <std::convertible_to<dimension_t> Ty>
+	std::string row_string(const Ty y) const {
+		std::string str(static_cast<size_t>(this->size_x), this->filler);
+		for (const auto& run : this->row_runs(y)) {
+			std::fill(str.begin() + run.x, str.begin() + run.end(), run.ch);
+		}
+		return str;
+	}
+
+	size_t count(const char ch) const {
+		size_t total = 0;
+		for (const auto& run : this->runs) {
+			total += run.ch == ch ? static_cast<size_t>(run.length) : 0;
+		}
+		if (ch == this->filler) {
+			total += static_cast<size_t>(this->size_x * this->size_y) - this->stored_cells();
+		}
+		return total;
+	}
+
+	/* Cells that are not filler */
+	size_t stored_cells() const {
+		size_t total = 0;
+		for (const auto& run : this->runs) {
+			total += static_cast<size_t>(run.length);
+		}
+		return total;
+	}
+
+   private:
+	std::span<const run_t> runs_of(size_t i) const {
+		return std::span<const run_t>(this->runs).subspan(this->row_first[i], this->row_first[i + 1] - this->row_first[i]);
+	}
+
+	/* Runs go in row by row, left to right */
+	void add_run(dimension_t y, dimension_t x, dimension_t length, char ch) {
+		if (this->row_y.empty() || this->row_y.back() != y) {
+			this->row_y.push_back(y);
+			this->row_first.push_back(this->runs.size());
+		}
+		this->runs.push_back({x, length, ch});
+		this->row_first.back() = this->runs.size();
+	}
+};
+
+#endif
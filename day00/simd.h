@@ -0,0 +1,27 @@
+#if !defined(SIMD_H)
+#define SIMD_H
+
+#include <cstddef>		// size_t
+#include <string>		// std::string
+#include <string_view>	// std::string_view
+
+/* SIMD kernels with runtime CPU dispatch.
+ *
+ * The Makefiles build for baseline x86-64 (SSE2) so the binaries run anywhere.
+ * Each kernel here is built several times (AVX-512, AVX2 and baseline) with
+ * target_clones and the loader picks the best one for the CPU at startup.
+ * Where that is not available (macOS, non-x86) there is only the baseline one.
+ */
+
+/* Return the number of `needle` in data[0..length) */
+extern size_t count_char(const char* data, size_t length, char needle);
+
+inline size_t count_char(std::string_view str, char needle) {
+	return count_char(str.data(), str.size(), needle);
+}
+
+inline size_t count_char(const std::string& str, char needle) {
+	return count_char(str.data(), str.size(), needle);
+}
+
+#endif
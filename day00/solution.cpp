@@ -5,12 +5,14 @@
 #include <chrono>	  // high resolution timer
 #include <cstring>	  // strtok, strdup
 #include <fstream>	  // ifstream (reading file)
+#include <future>	  // async (parallel parts)
 #include <numeric>	  // max, reduce, etc.
 #include <print>
 #include <ranges>  // ranges and views
 #include <string>  // strings
 #include <vector>  // collectin
 
+#include "differential.h"  // reference vs optimized checks
 #include "mrf.h"	// map, reduce, filter templates
 #include "split.h"	// split strings
 
@@ -48,15 +50,37 @@ result_t part2([[maybe_unused]] const data_t& data) {
 	return 0;
 }
 
+/* Return a random input of about `size`, for checking with -g */
+data_t generate_data([[maybe_unused]] size_t size, [[maybe_unused]] unsigned seed) {
+	return {};
+}
+
+/* Reference and optimized implementations that must agree, run with -d or -g */
+const vector<differential_t<data_t, result_t>> differentials = {
+	// {"part1", part1_reference, part1},
+};
+
 int main(int argc, char* argv[]) {
 	bool verbose = false;
+	bool parallel = false;
+	bool differential = false;
+	size_t generate_size = 0;
 
 	int c;
-	while ((c = getopt(argc, argv, "v")) != -1) {
+	while ((c = getopt(argc, argv, "vpdg:")) != -1) {
 		switch (c) {
 			case 'v':
 				verbose = !verbose;
 				break;
+			case 'p':
+				parallel = !parallel;
+				break;
+			case 'd':
+				differential = !differential;
+				break;
+			case 'g':
+				generate_size = stoul(optarg);
+				break;
 			default:
 				std::print(stderr, "ERROR: Unknown option \"{}\"\n", c);
 				exit(1);
@@ -66,6 +90,12 @@ int main(int argc, char* argv[]) {
 	argc -= optind;
 	argv += optind;
 
+	// check optimized against reference on generated inputs, no input file
+	if (generate_size) {
+		bool ok = run_differentials<data_t, result_t>(differentials, generate_data, generate_size);
+		exit(ok ? 0 : 3);
+	}
+
 	const char* input_file = argv[0];
 	if (argc != 1) {
 		std::print(stderr, "ERROR: No input file specified\n");
@@ -82,18 +112,44 @@ int main(int argc, char* argv[]) {
 		print("{:>15} ({:>10.4f}ms)\n", "parse", parse_time.count());
 	}
 
-	result_t p1_result = part1(data);
+	// check optimized against reference on the input file
+	if (differential) {
+		exit(run_differentials(differentials, data) ? 0 : 3);
+	}
 
-	auto p1_complete = chrono::high_resolution_clock::now();
-	duration_t p1_time = p1_complete - parse_complete;
-	print("{:>15} ({:>10.4f}ms){}", p1_result, p1_time.count(), verbose ? "\n" : "");
+	/* Run one part on the data, returning its result and how long it took. */
+	auto run_part = [&data](auto part) -> pair<result_t, duration_t> {
+		auto part_start = chrono::high_resolution_clock::now();
+		result_t result = part(data);
+		duration_t part_time = chrono::high_resolution_clock::now() - part_start;
+		return {result, part_time};
+	};
+
+	pair<result_t, duration_t> p1, p2;
+	if (parallel) {
+		// both parts only read data, so each can run on its own thread
+		auto p1_future = async(launch::async, run_part, part1);
+		auto p2_future = async(launch::async, run_part, part2);
+		p1 = p1_future.get();
+		p2 = p2_future.get();
+	} else {
+		p1 = run_part(part1);
+		p2 = run_part(part2);
+	}
+
+	auto parts_complete = chrono::high_resolution_clock::now();
 
-	result_t p2_result = part2(data);
+	auto [p1_result, p1_time] = p1;
+	print("{:>15} ({:>10.4f}ms){}", p1_result, p1_time.count(), verbose ? "\n" : "");
 
-	auto p2_complete = chrono::high_resolution_clock::now();
-	duration_t p2_time = p2_complete - p1_complete;
+	auto [p2_result, p2_time] = p2;
 	print("{:>15} ({:>10.4f}ms){}", p2_result, p2_time.count(), verbose ? "\n" : "");
 
-	duration_t total_time = p2_complete - start_time;
+	if (verbose) {
+		duration_t wall_time = parts_complete - parse_complete;
+		print("{:>15} ({:>10.4f}ms)\n", parallel ? "parallel" : "sequential", wall_time.count());
+	}
+
+	duration_t total_time = parts_complete - start_time;
 	print("{:>15} ({:>10.4f}ms)\n", "total", total_time.count());
 }
@@ -0,0 +1,152 @@
+#if !defined(SPARSE_GRID_H)
+#define SPARSE_GRID_H
+
+#include <array>		  // std::array
+#include <bit>			  // countr_zero
+#include <cstddef>		  // size_t
+#include <unordered_map>  // std::unordered_map
+#include <utility>		  // std::move
+
+#include "point.h"
+
+/* Unbounded grid made of dense B x B blocks of T, allocated on demand.
+ * Blocks are found by hashing their block coordinate (x/B, y/B, z, w), so
+ * z and w are sparse too; good for day17 layers and day24's hex floor.
+ * Memory is proportional to the blocks that were touched, not the bounding
+ * box, and iteration only visits blocks that exist.
+ *
+ * Cells that were never set read as T{}. B must be a power of two.
+ *
+ *	sparse_grid_t<uint8_t> grid;
+ *	grid.at({-100, 5})++;
+ *	grid.for_each([](const point_t& p, uint8_t v) { ... });
+ */
+template <typename T, dimension_t B = 16>
+struct sparse_grid_t {
+	static_assert(B > 0 && (B & (B - 1)) == 0, "block size must be a power of two");
+
+	static constexpr dimension_t block_size = B;
+
+	struct block_t {
+		point_t origin = {};		 // world coordinate of cell (0,0) in block
+		std::array<T, static_cast<size_t>(B * B)> cells = {};
+
+		// x and y are local to the block, 0 <= x,y < B
+		T& cell(dimension_t x, dimension_t y) {
+			return cells[static_cast<size_t>(y * B + x)];
+		}
+
+		const T& cell(dimension_t x, dimension_t y) const {
+			return cells[static_cast<size_t>(y * B + x)];
+		}
+	};
+
+	std::unordered_map<point_t, block_t> blocks = {};
+
+	sparse_grid_t() {
+	}
+
+	sparse_grid_t(const sparse_grid_t& other) : blocks(other.blocks) {
+	}
+
+	// other's cached block pointer now points into this grid's blocks
+	sparse_grid_t(sparse_grid_t&& other) noexcept : blocks(std::move(other.blocks)) {
+		other.last_block = nullptr;
+	}
+
+	// the cached block pointer is not copied, it points into the other grid
+	sparse_grid_t& operator=(const sparse_grid_t& other) {
+		blocks = other.blocks;
+		last_block = nullptr;
+		return *this;
+	}
+
+	sparse_grid_t& operator=(sparse_grid_t&& other) noexcept {
+		blocks = std::move(other.blocks);
+		last_block = nullptr;
+		other.last_block = nullptr;
+		return *this;
+	}
+
+	/* Block coordinate holding p; shifts floor negative coordinates correctly. */
+	static point_t block_key(const point_t& p) {
+		return {p.x >> shift, p.y >> shift, p.z, p.w};
+	}
+
+	/* Return the block with block coordinate key, or nullptr if there is none. */
+	const block_t* find_block(const point_t& key) const {
+		auto it = blocks.find(key);
+		return it == blocks.end() ? nullptr : &it->second;
+	}
+
+	T get(const point_t& p) const {
+		const block_t* block = find_block(block_key(p));
+		return block ? block->cell(p.x & mask, p.y & mask) : T{};
+	}
+
+	/* Reference to the cell at p, allocating its block if needed.
+	 * Remembers the last block, so runs of writes to nearby cells
+	 * (e.g. all the neighbors of a cell) are a direct index.
+	 */
+	T& at(const point_t& p) {
+		point_t key = block_key(p);
+		if (last_block == nullptr || !(key == last_key)) {
+			auto [it, inserted] = blocks.try_emplace(key);
+			if (inserted) {
+				it->second.origin = {key.x * B, key.y * B, key.z, key.w};
+			}
+
+			last_key = key;
+			last_block = &it->second;	// node based, stable across rehash
+		}
+
+		return last_block->cell(p.x & mask, p.y & mask);
+	}
+
+	void set(const point_t& p, const T value) {
+		this->at(p) = value;
+	}
+
+	size_t block_count() const {
+		return blocks.size();
+	}
+
+	/* Call f(block) for every allocated block. */
+	template <typename F>
+	void for_each_block(F f) const {
+		for (const auto& [key, block] : blocks) {
+			f(block);
+		}
+	}
+
+	/* Call f(point, value) for every cell that is not T{}. */
+	template <typename F>
+	void for_each(F f) const {
+		for (const auto& [key, block] : blocks) {
+			for (dimension_t y = 0; y < B; y++) {
+				for (dimension_t x = 0; x < B; x++) {
+					const T& value = block.cell(x, y);
+					if (value != T{}) {
+						f(point_t{block.origin.x + x, block.origin.y + y, block.origin.z, block.origin.w}, value);
+					}
+				}
+			}
+		}
+	}
+
+	/* Number of cells that are not T{}. */
+	size_t count() const {
+		size_t n = 0;
+		for_each([&n](const point_t&, const T&) { n++; });
+		return n;
+	}
+
+   private:
+	static constexpr dimension_t shift = std::countr_zero(static_cast<unsigned long>(B));
+	static constexpr dimension_t mask = B - 1;
+
+	point_t last_key = {};
+	block_t* last_block = nullptr;
+};
+
+#endif
@@ -0,0 +1,136 @@
+#if !defined(THREAD_POOL_T_H)
+#define THREAD_POOL_T_H
+
+#include <algorithm>			// min, max
+#include <atomic>				// next chunk
+#include <condition_variable>	// wake and done
+#include <cstddef>				// size_t
+#include <mutex>				// lock for the job
+#include <thread>				// jthread, hardware_concurrency
+#include <vector>				// std::vector
+
+/* A fixed set of threads for loops that are run in parallel many times over,
+ * like the phases of a parallel search, where starting threads for each one
+ * (as mrf.h's par() does) would cost more than the work.
+ *
+ * parallel_for(n, f) calls f(begin, end, worker) on chunks of [0, n) across
+ * the pool and the calling thread, and returns once every chunk is done.
+ * worker is 0 .. size() - 1, the same for all the chunks one thread runs, so
+ * f can collect results in a vector per worker without locking.
+ *
+ *	thread_pool_t pool;	 // one thread per core
+ *	std::vector<size_t> found(pool.size());
+ *	pool.parallel_for(cells.size(), [&](size_t begin, size_t end, size_t worker) {
+ *		for (size_t i = begin; i < end; i++) {
+ *			found[worker] += cells[i] == '#';
+ *		}
+ *	});
+ */
+struct thread_pool_t {
+	// threads including the caller, 0 is one per core
+	explicit thread_pool_t(size_t threads = 0) {
+		threads = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+		this->workers.reserve(threads - 1);
+		for (size_t worker = 1; worker < threads; worker++) {
+			this->workers.emplace_back([this, worker] { this->work(worker); });
+		}
+	}
+
+	thread_pool_t(const thread_pool_t&) = delete;
+	thread_pool_t& operator=(const thread_pool_t&) = delete;
+
+	~thread_pool_t() {
+		{
+			std::lock_guard lock(this->mutex);
+			this->stopping = true;
+		}
+		this->wake.notify_all();
+		// join now, while the mutex and condition variables the workers wait
+		// on still exist (members are destroyed after this body, workers last)
+		this->workers.clear();
+	}
+
+	// threads that run chunks, the caller included
+	size_t size() const {
+		return this->workers.size() + 1;
+	}
+
+	/* f(begin, end, worker) over [0, n), at least min_chunk at a time. Small
+	 * loops are run on the calling thread alone.
+	 */
+	template <typename F>
+	void parallel_for(size_t n, F f, size_t min_chunk = 256) {
+		if (this->workers.empty() || n <= min_chunk) {
+			if (n) {
+				f(size_t{0}, n, size_t{0});
+			}
+			return;
+		}
+
+		{
+			std::lock_guard lock(this->mutex);
+			this->run = [](void* context, size_t begin, size_t end, size_t worker) {
+				(*static_cast<F*>(context))(begin, end, worker);
+			};
+			this->context = &f;
+			this->size_n = n;
+			// a few chunks per thread, so one slow chunk does not hold up the rest
+			this->chunk = std::max(min_chunk, n / (this->size() * 4));
+			this->next = 0;
+			this->busy = this->workers.size();
+			this->generation++;
+		}
+		this->wake.notify_all();
+
+		this->run_chunks(0);
+
+		std::unique_lock lock(this->mutex);
+		this->done.wait(lock, [this] { return this->busy == 0; });
+	}
+
+   private:
+	std::vector<std::jthread> workers = {};
+	std::mutex mutex = {};
+	std::condition_variable wake = {};	// a job or stopping
+	std::condition_variable done = {};	// the last worker finished the job
+	size_t generation = 0;				// one per job, so workers see a new one
+	size_t busy = 0;					// workers still on the job
+	bool stopping = false;
+
+	// the job, type erased so the pool is not a template
+	void (*run)(void* context, size_t begin, size_t end, size_t worker) = nullptr;
+	void* context = nullptr;
+	size_t size_n = 0;
+	size_t chunk = 1;
+	std::atomic<size_t> next = 0;
+
+	void run_chunks(size_t worker) {
+		for (size_t begin = this->next.fetch_add(this->chunk); begin < this->size_n;
+			 begin = this->next.fetch_add(this->chunk)) {
+			this->run(this->context, begin, std::min(this->size_n, begin + this->chunk), worker);
+		}
+	}
+
+	void work(size_t worker) {
+		size_t seen = 0;
+		while (true) {
+			{
+				std::unique_lock lock(this->mutex);
+				this->wake.wait(lock, [this, seen] { return this->stopping || this->generation != seen; });
+				if (this->stopping) {
+					return;
+				}
+				seen = this->generation;
+			}
+
+			this->run_chunks(worker);
+
+			std::lock_guard lock(this->mutex);
+			if (--this->busy == 0) {
+				this->done.notify_one();
+			}
+		}
+	}
+};
+
+#endif
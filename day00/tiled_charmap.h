@@ -0,0 +1,227 @@
+#if !defined(TILED_CHARMAP_T_H)
+#define TILED_CHARMAP_T_H
+
+#include <algorithm>  // copy, min
+#include <cstddef>	// size_t
+#include <vector>	// std::vector
+
+#include "charmap.h"
+#include "point.h"
+
+/* charmap_t laid out in 64 x 64 tiles, each tile's cells contiguous.
+ *
+ * For maps far bigger than the cache a row-major walk touches three rows a
+ * long way apart for every 8-neighbour probe, and a walk down a column
+ * touches a new line every step. Here a cell and its neighbours are almost
+ * always in the same 4KB tile, and a column is 64 bytes apart for 64 rows.
+ * The iterators go a tile at a time so a stencil works on one tile while it
+ * is hot.
+ *
+ * Edge tiles are padded out to 64 x 64 with '\0', which is also what get()
+ * returns off the map.
+ *
+ *	tiled_charmap_t tiled = tiled_charmap_t::from_charmap(map);
+ *	auto next = tiled.transform([&tiled](dimension_t x, dimension_t y, char ch) {
+ *		return tiled.count_neighbors(x, y, '#') > 3 ? 'L' : ch;
+ *	});
+ */
+struct tiled_charmap_t {
+	static constexpr dimension_t tile_bits = 6;
+	static constexpr dimension_t tile = dimension_t{1} << tile_bits;
+	static constexpr dimension_t tile_mask = tile - 1;
+	static constexpr size_t tile_cells = static_cast<size_t>(tile * tile);
+
+	dimension_t size_x = 0;
+	dimension_t size_y = 0;
+	dimension_t tiles_x = 0;
+	dimension_t tiles_y = 0;
+	std::vector<char> cells = {};
+
+	/* One tile, tile chars a row. C is char or const char. */
+	template <typename C>
+	struct tile_view_t {
+		dimension_t origin_x;  // map coordinate of the tile's cell 0, 0
+		dimension_t origin_y;
+		dimension_t size_x;	   // cells of the tile on the map, <= tile
+		dimension_t size_y;
+		C* cells;
+
+		// x and y are local to the tile
+		C& cell(dimension_t x, dimension_t y) const {
+			return cells[(y << tile_bits) + x];
+		}
+	};
+
+	tiled_charmap_t() {
+	}
+
+	// size_x x size_y of fill
+	template <std::convertible_to<dimension_t> Tx, std::convertible_to<dimension_t> Ty>
+	tiled_charmap_t(Tx size_x, Ty size_y, char fill = '\0')
+		: size_x(static_cast<dimension_t>(size_x)),
+		  size_y(static_cast<dimension_t>(size_y)),
+		  tiles_x((this->size_x + tile_mask) >> tile_bits),
+		  tiles_y((this->size_y + tile_mask) >> tile_bits),
+		  cells(static_cast<size_t>(tiles_x * tiles_y) * tile_cells, '\0') {
+		if (fill != '\0') {
+			this->for_each_tile([fill](const tile_view_t<char>& t) {
+				for (dimension_t y = 0; y < t.size_y; y++) {
+					for (dimension_t x = 0; x < t.size_x; x++) {
+						t.cell(x, y) = fill;
+					}
+				}
+			});
+		}
+	}
+
+	static tiled_charmap_t from_charmap(const charmap_t& map) {
+		tiled_charmap_t tiled(map.size_x, map.size_y);
+		tiled.for_each_tile([&map](const tile_view_t<char>& t) {
+			for (dimension_t y = 0; y < t.size_y; y++) {
+				auto row = map.row(t.origin_y + y).subspan(static_cast<size_t>(t.origin_x),
+														   static_cast<size_t>(t.size_x));
+				std::copy(row.begin(), row.end(), &t.cell(0, y));
+			}
+		});
+		return tiled;
+	}
+
+	charmap_t to_charmap() const {
+		charmap_t map(this->size_x, this->size_y);
+		this->for_each_tile([&map](const tile_view_t<const char>& t) {
+			for (dimension_t y = 0; y < t.size_y; y++) {
+				const char* src = &t.cell(0, y);
+				std::copy(src, src + t.size_x, map.row(t.origin_y + y).begin() + t.origin_x);
+			}
+		});
+		return map;
+	}
+
+	template <std::convertible_to<dimension_t> Tx, std::convertible_to<dimension_t> Ty>
+	bool is_valid(const Tx x, const Ty y) const {
+		dimension_t native_x = static_cast<dimension_t>(x);
+		dimension_t native_y = static_cast<dimension_t>(y);
+		return 0 <= native_x && native_x < this->size_x && 0 <= native_y && native_y < this->size_y;
+	}
+
+	bool is_valid(const point_t& p) const {
+		return is_valid(p.x, p.y);
+	}
+
+	/* Offset of x, y in cells, which must be on the map */
+	size_t index(const dimension_t x, const dimension_t y) const {
+		dimension_t tile_index = (y >> tile_bits) * this->tiles_x + (x >> tile_bits);
+		return static_cast<size_t>((tile_index << (2 * tile_bits)) + ((y & tile_mask) << tile_bits) + (x & tile_mask));
+	}
+
+	template <std::convertible_to<dimension_t> Tx, std::convertible_to<dimension_t> Ty>
+	char get(const Tx x, const Ty y, const char invalid = '\0') const {
+		return this->is_valid(x, y)
+				   ? this->cells[this->index(static_cast<dimension_t>(x), static_cast<dimension_t>(y))]
+				   : invalid;
+	}
+
+	char get(const point_t& p, const char invalid = '\0') const {
+		return this->get(p.x, p.y, invalid);
+	}
+
+	template <std::convertible_to<dimension_t> Tx, std::convertible_to<dimension_t> Ty,
+			  std::convertible_to<char> Tc>
+	void set(const Tx x, const Ty y, const Tc c) {
+		if (this->is_valid(x, y)) {
+			this->cells[this->index(static_cast<dimension_t>(x), static_cast<dimension_t>(y))] = static_cast<char>(c);
+		}
+	}
+
+	template <std::convertible_to<char> Tc>
+	void set(const point_t& p, const Tc c) {
+		this->set(p.x, p.y, c);
+	}
+
+	bool is_char(const point_t& p, const char c) const {
+		return this->get(p) == c;
+	}
+
+	template <typename C>
+	tile_view_t<C> tile_at(dimension_t tx, dimension_t ty, C* base) const {
+		dimension_t origin_x = tx << tile_bits;
+		dimension_t origin_y = ty << tile_bits;
+		return {origin_x, origin_y,
+				std::min(tile, this->size_x - origin_x), std::min(tile, this->size_y - origin_y),
+				base + static_cast<size_t>(ty * this->tiles_x + tx) * tile_cells};
+	}
+
+	/* f(tile) for each tile, row of tiles by row of tiles */
+	template <typename F>
+	void for_each_tile(F&& f) {
+		for (dimension_t ty = 0; ty < this->tiles_y; ty++) {
+			for (dimension_t tx = 0; tx < this->tiles_x; tx++) {
+				f(this->tile_at(tx, ty, this->cells.data()));
+			}
+		}
+	}
+
+	template <typename F>
+	void for_each_tile(F&& f) const {
+		for (dimension_t ty = 0; ty < this->tiles_y; ty++) {
+			for (dimension_t tx = 0; tx < this->tiles_x; tx++) {
+				f(this->tile_at(tx, ty, this->cells.data()));
+			}
+		}
+	}
+
+	/* f(x, y, ch) for every cell, a tile at a time */
+	template <typename F>
+	void for_each(F&& f) const {
+		this->for_each_tile([&f](const tile_view_t<const char>& t) {
+			for (dimension_t y = 0; y < t.size_y; y++) {
+				for (dimension_t x = 0; x < t.size_x; x++) {
+					f(t.origin_x + x, t.origin_y + y, t.cell(x, y));
+				}
+			}
+		});
+	}
+
+	/* New map of f(x, y, ch) for every cell, a tile at a time */
+	template <typename F>
+	tiled_charmap_t transform(F&& f) const {
+		tiled_charmap_t result = *this;
+		const char* base = result.cells.data();
+		result.for_each_tile([this, &f, base](const tile_view_t<char>& t) {
+			const char* src = this->cells.data() + (t.cells - base);
+			for (dimension_t y = 0; y < t.size_y; y++) {
+				for (dimension_t x = 0; x < t.size_x; x++) {
+					t.cell(x, y) = f(t.origin_x + x, t.origin_y + y, src[(y << tile_bits) + x]);
+				}
+			}
+		});
+		return result;
+	}
+
+	/* Number of the 8 neighbours of x, y that are ch. Away from the tile
+	 * edges they are all in the tile, at fixed offsets, with no checks.
+	 */
+	size_t count_neighbors(const dimension_t x, const dimension_t y, const char ch) const {
+		dimension_t local_x = x & tile_mask;
+		dimension_t local_y = y & tile_mask;
+		size_t count = 0;
+		if (0 < local_x && local_x < tile_mask && 0 < local_y && local_y < tile_mask) {
+			const char* p = this->cells.data() + this->index(x, y);
+			for (const dimension_t dy : {-tile, dimension_t{0}, tile}) {
+				count += static_cast<size_t>((p[dy - 1] == ch) + (p[dy + 1] == ch) + (dy != 0 && p[dy] == ch));
+			}
+			return count;
+		}
+
+		for (dimension_t dy = -1; dy <= 1; dy++) {
+			for (dimension_t dx = -1; dx <= 1; dx++) {
+				if ((dx || dy) && this->get(x + dx, y + dy) == ch) {
+					count++;
+				}
+			}
+		}
+		return count;
+	}
+};
+
+#endif
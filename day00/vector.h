@@ -96,7 +96,13 @@ std::ostream& operator<<(std::ostream& os, const vector_t& p);
 template <>
 struct std::hash<vector_t> {
 	size_t operator()(const vector_t& v) const {
-		return std::hash<size_t>()((((size_t)v.p.x & 0xFFFF) << 32) | (((size_t)v.p.y & 0xFFFF) << 24) | (((size_t)v.dir.x & 0xFFFF) << 16) | (((size_t)v.dir.y & 0xFFFF)));
+		uint64_t h = 0;
+		for (const auto& p : {v.p, v.dir}) {
+			for (size_t i = 0; i < point_t::dimensions; i++) {
+				h = hash_combine(h, static_cast<uint64_t>(p[i]));
+			}
+		}
+		return hash_mix(h);
 	}
 };
 #endif
\ No newline at end of file
@@ -1,6 +1,7 @@
 #if !defined(POINT_T_H)
 #define POINT_T_H
 
+#include <charconv>	 // from_chars
 #include <concepts>
 #include <iomanip>	 // setw and setprecision on output
 #include <iostream>	 // cout
@@ -133,7 +134,9 @@ struct point_t {
 			size_t start = str.find_first_of(digits, 0);
 			size_t end = str.find_first_not_of(digits, start);
 			while (start != std::string::npos) {
-				result.push_back(std::stol(str.substr(start)));
+				long n = 0;
+				std::from_chars(str.data() + start, str.data() + str.size(), n);
+				result.push_back(n);
 
 				start = str.find_first_of(digits, end);
 				end = str.find_first_not_of(digits, start);
@@ -11,6 +11,7 @@
 #include <print>	  // std::print
 #include <ranges>	  // ranges and views
 #include <string>	  // strings
+#include <iterator>	  // istreambuf_iterator
 #include <vector>	  // collectin
 
 #include "split.h"
@@ -26,14 +27,10 @@ using duration_t = chrono::duration<double, milli>;
 const data_t read_data(const string& filename) {
 	data_t data;
 
+	// one number per line, parse the whole file in one go
 	std::ifstream ifs(filename);
-
-	string line;
-	while (getline(ifs, line)) {
-		if (!line.empty()) {
-			data.push_back(stoi(line));
-		}
-	}
+	string text{istreambuf_iterator<char>(ifs), istreambuf_iterator<char>()};
+	parse_ints<int>(text, data);
 
 	return data;
 }
@@ -0,0 +1,34 @@
+#include "simd.h"
+
+#include <cstdint>	// uint8_t
+
+/* Build each kernel for x86-64-v4 (AVX-512), x86-64-v3 (AVX2) and baseline;
+ * the ifunc resolver picks one when the program is loaded. The loops are
+ * kept plain so the compiler can vectorize them for each target.
+ */
+#if defined(__x86_64__) && defined(__ELF__)
+#define SIMD_CLONES __attribute__((target_clones("arch=x86-64-v4", "arch=x86-64-v3", "default")))
+#else
+#define SIMD_CLONES
+#endif
+
+SIMD_CLONES
+size_t count_char(const char* data, size_t length, char needle) {
+	size_t count = 0;
+
+	// count in blocks of 255 so the compiler can keep byte wide lanes
+	while (length) {
+		size_t block = length < 255 ? length : 255;
+
+		uint8_t block_count = 0;
+		for (size_t i = 0; i < block; i++) {
+			block_count = static_cast<uint8_t>(block_count + (data[i] == needle));
+		}
+
+		count += block_count;
+		data += block;
+		length -= block;
+	}
+
+	return count;
+}
@@ -13,6 +13,7 @@
 #include <string>	  // strings
 #include <vector>	  // collectin
 
+#include "simd.h"
 #include "split.h"
 
 using namespace std;
@@ -22,12 +23,7 @@ struct rule_t {
 	char required_char;
 
 	bool range_validate(const string& password) {
-		int matches = 0;
-		for (auto c : password) {
-			if (c == required_char) {
-				matches++;
-			}
-		}
+		int matches = static_cast<int>(count_char(password, required_char));
 
 		return range.first <= matches && matches <= range.second;
 	}
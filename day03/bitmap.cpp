@@ -0,0 +1,185 @@
+#include "bitmap.h"
+
+#include <bit>	// popcount
+
+using word_t = bitmap_t::word_t;
+
+bitmap_t bitmap_t::from_charmap(const charmap_t& map, const char ch) {
+	bitmap_t bitmap(map.size_x, map.size_y);
+
+	for (dimension_t y = 0; y < map.size_y; y++) {
+		auto src = map.row(y);
+		auto dst = bitmap.row(y);
+		// build a word at a time, the compare loop vectorizes
+		for (size_t w = 0; w < bitmap.words; w++) {
+			size_t first = w * word_bits;
+			size_t last = std::min(first + word_bits, src.size());
+			word_t word = 0;
+			for (size_t x = first; x < last; x++) {
+				word |= word_t{src[x] == ch} << (x - first);
+			}
+			dst[w] = word;
+		}
+	}
+
+	return bitmap;
+}
+
+void bitmap_t::paint(charmap_t& map, const char ch) const {
+	for (dimension_t y = 0; y < this->size_y; y++) {
+		auto src = this->row(y);
+		auto dst = map.row(y);
+		for (size_t x = 0; x < dst.size(); x++) {
+			if ((src[x / word_bits] >> (x % word_bits)) & 1) {
+				dst[x] = ch;
+			}
+		}
+	}
+}
+
+size_t bitmap_t::count() const {
+	size_t total = 0;
+	for (const auto word : this->bits) {
+		total += static_cast<size_t>(std::popcount(word));
+	}
+	return total;
+}
+
+void bitmap_t::clear_tail() {
+	size_t used = static_cast<size_t>(this->size_x) % word_bits;
+	if (used == 0) {
+		return;
+	}
+
+	word_t mask = (word_t{1} << used) - 1;
+	for (dimension_t y = 0; y < this->size_y; y++) {
+		this->row(y)[this->words - 1] &= mask;
+	}
+}
+
+/* Row as the left (x - 1) and right (x + 1) neighbour of each cell */
+static word_t from_left(std::span<const word_t> row, size_t w) {
+	return (row[w] << 1) | (w > 0 ? row[w - 1] >> 63 : 0);
+}
+
+static word_t from_right(std::span<const word_t> row, size_t w) {
+	return (row[w] >> 1) | (w + 1 < row.size() ? row[w + 1] << 63 : 0);
+}
+
+/* Full adder across 64 lanes: a + b + c = sum + 2 * carry */
+static void full_add(word_t a, word_t b, word_t c, word_t& sum, word_t& carry) {
+	sum = a ^ b ^ c;
+	carry = (a & b) | (c & (a ^ b));
+}
+
+bitmap_t::planes_t bitmap_t::neighbor_counts() const {
+	planes_t planes;
+	planes.fill(bitmap_t(this->size_x, this->size_y));
+
+	const std::vector<word_t> empty(this->words, 0);
+	for (dimension_t y = 0; y < this->size_y; y++) {
+		auto above = y > 0 ? this->row(y - 1) : std::span<const word_t>(empty);
+		auto middle = this->row(y);
+		auto below = y + 1 < this->size_y ? this->row(y + 1) : std::span<const word_t>(empty);
+
+		for (size_t w = 0; w < this->words; w++) {
+			// the three cells above and below count 0..3, the two beside 0..2
+			word_t a0, a1, b0, b1;
+			full_add(from_left(above, w), above[w], from_right(above, w), a0, a1);
+			full_add(from_left(below, w), below[w], from_right(below, w), b0, b1);
+			word_t m_left = from_left(middle, w);
+			word_t m_right = from_right(middle, w);
+			word_t m0 = m_left ^ m_right;
+			word_t m1 = m_left & m_right;
+
+			// add the three 2 bit numbers, up to 8 needs 4 bits
+			word_t s0, c0, t1, c1;
+			full_add(a0, b0, m0, s0, c0);
+			full_add(a1, b1, m1, t1, c1);
+			word_t s1 = t1 ^ c0;
+			word_t c2 = t1 & c0;
+
+			size_t at = static_cast<size_t>(y) * this->words + w;
+			planes[0].bits[at] = s0;
+			planes[1].bits[at] = s1;
+			planes[2].bits[at] = c1 ^ c2;
+			planes[3].bits[at] = c1 & c2;
+		}
+	}
+
+	// the shifts bring in bits from past the edge, clear them
+	for (auto& plane : planes) {
+		plane.clear_tail();
+	}
+
+	return planes;
+}
+
+bitmap_t bitmap_t::count_is(const planes_t& planes, unsigned n) {
+	bitmap_t result(planes[0].size_x, planes[0].size_y);
+	for (size_t i = 0; i < result.bits.size(); i++) {
+		word_t equal = ~word_t{0};
+		for (size_t p = 0; p < planes.size(); p++) {
+			equal &= ((n >> p) & 1) ? planes[p].bits[i] : ~planes[p].bits[i];
+		}
+		result.bits[i] = equal;
+	}
+	result.clear_tail();
+	return result;
+}
+
+bitmap_t bitmap_t::count_at_least(const planes_t& planes, unsigned n) {
+	bitmap_t result(planes[0].size_x, planes[0].size_y);
+	if (n > 15) {
+		return result;
+	}
+
+	// compare from the top plane down: greater at the first bit where the
+	// count has a 1 and n a 0, as long as all the bits above were equal
+	for (size_t i = 0; i < result.bits.size(); i++) {
+		word_t greater = 0;
+		word_t equal = ~word_t{0};
+		for (size_t p = planes.size(); p-- > 0;) {
+			word_t bit = planes[p].bits[i];
+			if ((n >> p) & 1) {
+				equal &= bit;
+			} else {
+				greater |= equal & bit;
+				equal &= ~bit;
+			}
+		}
+		result.bits[i] = greater | equal;
+	}
+	result.clear_tail();
+	return result;
+}
+
+bitmap_t bitmap_t::operator~() const {
+	bitmap_t result = *this;
+	for (auto& word : result.bits) {
+		word = ~word;
+	}
+	result.clear_tail();
+	return result;
+}
+
+bitmap_t& bitmap_t::operator&=(const bitmap_t& other) {
+	for (size_t i = 0; i < this->bits.size(); i++) {
+		this->bits[i] &= other.bits[i];
+	}
+	return *this;
+}
+
+bitmap_t& bitmap_t::operator|=(const bitmap_t& other) {
+	for (size_t i = 0; i < this->bits.size(); i++) {
+		this->bits[i] |= other.bits[i];
+	}
+	return *this;
+}
+
+bitmap_t& bitmap_t::operator^=(const bitmap_t& other) {
+	for (size_t i = 0; i < this->bits.size(); i++) {
+		this->bits[i] ^= other.bits[i];
+	}
+	return *this;
+}
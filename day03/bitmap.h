@@ -0,0 +1,146 @@
+#if !defined(BITMAP_T_H)
+#define BITMAP_T_H
+
+#include <array>	 // neighbor count planes
+#include <cstdint>	 // uint64_t
+#include <format>
+#include <span>		 // rows
+#include <vector>	 // std::vector
+
+#include "charmap.h"
+#include "point.h"
+
+/* A bit per cell companion to charmap_t, for maps that only need to know
+ * whether a cell is one thing or not (tree, occupied seat, ...).
+ *
+ * Each row is packed into 64 bit words, bit x % 64 of word x / 64, and the
+ * bits past size_x in the last word are always zero. Whole maps combine
+ * with & | ^ ~, and neighbor_counts() counts the 8 neighbours of every cell
+ * a word (64 cells) at a time.
+ */
+struct bitmap_t {
+	using word_t = uint64_t;
+	static constexpr size_t word_bits = 64;
+
+	dimension_t size_x = 0;
+	dimension_t size_y = 0;
+	size_t words = 0;  // words per row
+	std::vector<word_t> bits = {};
+
+	bitmap_t() {
+	}
+
+	// all clear, size_x x size_y
+	template <std::convertible_to<dimension_t> Tx, std::convertible_to<dimension_t> Ty>
+	bitmap_t(Tx size_x, Ty size_y)
+		: size_x(static_cast<dimension_t>(size_x)),
+		  size_y(static_cast<dimension_t>(size_y)),
+		  words((static_cast<size_t>(size_x) + word_bits - 1) / word_bits),
+		  bits(words * static_cast<size_t>(size_y), 0) {
+	}
+
+	/* Set where the map has ch */
+	static bitmap_t from_charmap(const charmap_t& map, const char ch);
+
+	/* Put ch in map wherever this is set */
+	void paint(charmap_t& map, const char ch) const;
+
+	template <std::convertible_to<dimension_t> Tx, std::convertible_to<dimension_t> Ty>
+	bool is_valid(const Tx x, const Ty y) const {
+		dimension_t native_x = static_cast<dimension_t>(x);
+		dimension_t native_y = static_cast<dimension_t>(y);
+		return 0 <= native_x && native_x < this->size_x && 0 <= native_y && native_y < this->size_y;
+	}
+
+	bool is_valid(const point_t& p) const {
+		return is_valid(p.x, p.y);
+	}
+
+	template <std::convertible_to<dimension_t> Tx, std::convertible_to<dimension_t> Ty>
+	bool get(const Tx x, const Ty y) const {
+		if (!this->is_valid(x, y)) {
+			return false;
+		}
+		size_t bit = static_cast<size_t>(x);
+		return (this->row(y)[bit / word_bits] >> (bit % word_bits)) & 1;
+	}
+
+	bool get(const point_t& p) const {
+		return this->get(p.x, p.y);
+	}
+
+	template <std::convertible_to<dimension_t> Tx, std::convertible_to<dimension_t> Ty>
+	void set(const Tx x, const Ty y, const bool value = true) {
+		if (this->is_valid(x, y)) {
+			size_t bit = static_cast<size_t>(x);
+			word_t mask = word_t{1} << (bit % word_bits);
+			word_t& word = this->row(y)[bit / word_bits];
+			word = value ? (word | mask) : (word & ~mask);
+		}
+	}
+
+	void set(const point_t& p, const bool value = true) {
+		this->set(p.x, p.y, value);
+	}
+
+	template <std::convertible_to<dimension_t> Ty>
+	std::span<word_t> row(const Ty y) {
+		return {this->bits.data() + static_cast<size_t>(y) * this->words, this->words};
+	}
+
+	template <std::convertible_to<dimension_t> Ty>
+	std::span<const word_t> row(const Ty y) const {
+		return {this->bits.data() + static_cast<size_t>(y) * this->words, this->words};
+	}
+
+	/* Number of set cells */
+	size_t count() const;
+
+	/* The neighbour counts of every cell as 4 bit planes, so the count at
+	 * x, y is planes[0].get(x, y) + 2 * planes[1].get(x, y) + 4 * ... .
+	 * Cells outside the map count as clear.
+	 */
+	using planes_t = std::array<bitmap_t, 4>;
+	planes_t neighbor_counts() const;
+
+	/* Cells whose count in planes is n, or at least n */
+	static bitmap_t count_is(const planes_t& planes, unsigned n);
+	static bitmap_t count_at_least(const planes_t& planes, unsigned n);
+
+	bitmap_t operator~() const;
+	bitmap_t& operator&=(const bitmap_t& other);
+	bitmap_t& operator|=(const bitmap_t& other);
+	bitmap_t& operator^=(const bitmap_t& other);
+
+	friend bitmap_t operator&(bitmap_t a, const bitmap_t& b) { return a &= b; }
+	friend bitmap_t operator|(bitmap_t a, const bitmap_t& b) { return a |= b; }
+	friend bitmap_t operator^(bitmap_t a, const bitmap_t& b) { return a ^= b; }
+
+	bool operator==(const bitmap_t& other) const = default;
+
+   private:
+	/* Zero the bits past size_x in the last word of each row */
+	void clear_tail();
+};
+
+/* Print as '#' and '.' */
+template <>
+struct std::formatter<bitmap_t> {
+	constexpr auto parse(std::format_parse_context& ctx) {
+		return ctx.begin();
+	}
+
+	auto format(const bitmap_t& map, std::format_context& ctx) const {
+		auto out = ctx.out();
+		for (dimension_t y = 0; y < map.size_y; y++) {
+			for (dimension_t x = 0; x < map.size_x; x++) {
+				std::format_to(out, "{}", map.get(x, y) ? '#' : '.');
+			}
+			std::format_to(out, "\n");
+		}
+
+		return out;
+	}
+};
+
+#endif
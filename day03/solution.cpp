@@ -13,25 +13,26 @@
 #include <string>	  // strings
 #include <vector>	  // collectin
 
+#include "bitmap.h"	// trees, a bit per cell
 #include "charmap.h"
 
 using namespace std;
 
-using data_t = charmap_t;
+using data_t = bitmap_t;
 using result_t = size_t;
 
 /* for pretty printing durations */
 using duration_t = chrono::duration<double, milli>;
 
 const data_t read_data(const string& filename) {
-	return charmap_t::from_file(filename);
+	return bitmap_t::from_charmap(charmap_t::map_file(filename), '#');
 }
 
 result_t run_trail(const data_t& map, const point_t& move) {
 	size_t trees = 0;
 	point_t pos = {0, 0};
 	while (pos.y < map.size_y) {
-		if (map.is_char(pos, '#')) {
+		if (map.get(pos)) {
 			trees++;
 		}
 
@@ -16,6 +16,7 @@
 #include <unordered_map>
 #include <vector>  // collectin
 
+#include "mrf.h"	// map, reduce, filter templates
 #include "split.h"
 
 using namespace std;
@@ -119,11 +120,6 @@ void show_field(const passport_t& passport, const string& field_name) {
 using data_t = vector<passport_t>;
 using result_t = size_t;
 
-template <typename T, typename U>
-T reduce(const std::vector<U> vec, const T start, std::function<T(T, U)> func) {
-	return std::accumulate(vec.begin(), vec.end(), start, func);
-}
-
 const data_t read_data(const string& filename) {
 	data_t data;
 
@@ -149,7 +145,7 @@ const data_t read_data(const string& filename) {
 
 /* Part 1 */
 result_t part1(const data_t& data) {
-	size_t valid = reduce<size_t, passport_t>(data, (size_t)0, [](size_t a, const passport_t& b) {
+	size_t valid = reduce<passport_t, size_t>(data, (size_t)0, [](size_t a, const passport_t& b) {
 		return a + (b.validate_fields() ? 1 : 0);
 	});
 
@@ -166,7 +162,7 @@ result_t part2([[maybe_unused]] const data_t& data) {
 	// 	cout << endl;
 	// }
 
-	size_t valid = reduce<size_t, passport_t>(data, (size_t)0, [](size_t a, const passport_t& b) {
+	size_t valid = reduce<passport_t, size_t>(data, (size_t)0, [](size_t a, const passport_t& b) {
 		return a + (b.validate() ? 1 : 0);
 	});
 
@@ -14,6 +14,7 @@
 #include <string>  // strings
 #include <vector>  // collectin
 
+#include "mrf.h"	// map, reduce, filter templates
 #include "split.h"
 
 using namespace std;
@@ -24,29 +25,6 @@ using result_t = size_t;
 /* for pretty printing durations */
 using duration_t = chrono::duration<double, milli>;
 
-/* Reduce vector of U to single T */
-template <typename T, typename R>
-R reduce(const std::vector<T> vec, const R start, std::function<R(T, R)> func) {
-	return std::accumulate(vec.begin(), vec.end(), start, func);
-}
-
-/* Map vector of S to vector of D */
-template <typename T, typename R>
-std::vector<R> map(const std::vector<T>& src,
-				   const std::function<R(const T&)> func) {
-	std::vector<R> dst;
-	dst.reserve(src.size());
-
-	// this seems slightly faster than the loop below.
-	std::transform(src.begin(), src.end(), std::back_inserter(dst), func);
-
-	// for (const auto &e : src) {
-	//   dst.emplace_back(func(e));
-	// }
-
-	return dst;
-}
-
 const data_t read_data(const string& filename) {
 	data_t data;
 
@@ -99,13 +77,8 @@ result_t decode_pass(const string& pass) {
 }
 
 result_t part1(const data_t& passes) {
-	/* map passes to seat ids */
-	auto seats = map<string, result_t>(passes, decode_pass);
-
-	/* find the largest one */
-	auto largest_seat = *std::max_element(seats.begin(), seats.end());
-
-	return largest_seat;
+	/* decode each pass and keep the largest seat id, no vector in between */
+	return from(passes) | map(decode_pass) | max();
 }
 
 result_t part2([[maybe_unused]] const data_t& passes) {
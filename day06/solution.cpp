@@ -14,6 +14,8 @@
 #include <unordered_map>
 #include <vector>  // collectin
 
+#include "mrf.h"	// map, reduce, filter templates
+
 using namespace std;
 
 using group_t = std::vector<std::string>;
@@ -23,22 +25,6 @@ using result_t = size_t;
 /* for pretty printing durations */
 using duration_t = chrono::duration<double, milli>;
 
-/* Reduce vector of U to single T */
-template <typename T, typename R>
-R reduce(const std::vector<T> vec, const R start, std::function<R(T, R)> func) {
-	return std::accumulate(vec.begin(), vec.end(), start, func);
-}
-
-/* Map vector of S to vector of D */
-template <typename T, typename R>
-std::vector<R> map(const std::vector<T>& src,
-				   const std::function<R(const T&)> func) {
-	std::vector<R> dst;
-	dst.reserve(src.size());
-	std::transform(src.begin(), src.end(), std::back_inserter(dst), func);
-	return dst;
-}
-
 const data_t read_data(const string& filename) {
 	data_t data;
 
@@ -110,10 +96,8 @@ result_t common_answers_count(const vector<string>& group) {
 }
 
 result_t part1(const data_t& groups) {
-	// map groups to unique answers in the group
-	auto answers = map<vector<string>, result_t>(groups, unique_answers_count);
-	// reduce to sum of all counts
-	return reduce<result_t, result_t>(answers, 0, std::plus<result_t>());
+	// sum the unique answers of each group in one pass
+	return from(groups) | map(unique_answers_count) | sum();
 }
 
 result_t part2([[maybe_unused]] const data_t& groups) {
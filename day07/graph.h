@@ -0,0 +1,249 @@
+#if !defined(GRAPH_H)
+#define GRAPH_H
+
+#include <algorithm>	 // sort, lower_bound, reverse
+#include <array>		 // neighbour_list_t
+#include <cassert>
+#include <concepts>		 // convertible_to
+#include <cstddef>		 // size_t
+#include <cstdint>		 // uint32_t
+#include <ranges>		 // range
+#include <span>			 // csr neighbours
+#include <tuple>		 // edges
+#include <type_traits>	 // is_invocable_v
+#include <vector>		 // std::vector
+
+#include "bucket_queue.h"
+
+/* A graph graph_dijkstra() can search: vertices 0 .. size() - 1,
+ * neighbours(u) the vertices there is an edge to from u, and weight(u, v)
+ * the cost of that edge.
+ *
+ * A graph that stores its weights can also have weights_of(u), the weight
+ * of each of neighbours(u) in the same order, which graph_dijkstra() reads
+ * instead of calling weight(u, v) for each edge.
+ */
+template <typename G>
+concept graph_c = requires(const G& graph, size_t u, size_t v) {
+	{ graph.size() } -> std::convertible_to<size_t>;
+	{ graph.neighbours(u) } -> std::ranges::range;
+	{ graph.weight(u, v) } -> std::convertible_to<size_t>;
+};
+
+template <typename G>
+concept weighted_graph_c = graph_c<G> && requires(const G& graph, size_t u) {
+	{ graph.weights_of(u) } -> std::ranges::random_access_range;
+};
+
+/* Up to N neighbours, kept in place, for graphs that work them out on the
+ * fly (e.g. the cells around a cell) rather than storing them.
+ */
+template <size_t N>
+struct neighbour_list_t {
+	std::array<uint32_t, N> vertices = {};
+	size_t count = 0;
+
+	void push_back(size_t v) {
+		assert(this->count < N);
+		this->vertices[this->count++] = static_cast<uint32_t>(v);
+	}
+
+	const uint32_t* begin() const {
+		return this->vertices.data();
+	}
+
+	const uint32_t* end() const {
+		return this->vertices.data() + this->count;
+	}
+};
+
+/* Adjacency as compressed sparse rows: the targets of every vertex's edges
+ * one after the other in one array, sorted, with the weights alongside, and
+ * where each vertex's start. No node or vector per vertex.
+ *
+ *	csr_graph_t graph = csr_graph_t::from_edges(n, {{0, 1, 5}, {1, 2, 1}});
+ *	auto targets = graph.neighbours(0);
+ *	auto weights = graph.weights_of(0);	 // weights[i] is the edge to targets[i]
+ */
+struct csr_graph_t {
+	using edge_t = std::tuple<uint32_t, uint32_t, size_t>;	// from, to, weight
+
+	std::vector<uint32_t> first = {0};	 // edges of v are first[v] .. first[v + 1]
+	std::vector<uint32_t> targets = {};
+	std::vector<size_t> weights = {};
+
+	/* vertices 0 .. vertices - 1; of two edges between the same vertices
+	 * the cheaper is kept
+	 */
+	static csr_graph_t from_edges(size_t vertices, std::vector<edge_t> edges) {
+		std::sort(edges.begin(), edges.end());
+
+		csr_graph_t graph;
+		graph.first.assign(vertices + 1, 0);
+		for (size_t i = 0; i < edges.size(); i++) {
+			const auto& [from, to, weight] = edges[i];
+			assert(from < vertices && to < vertices);
+			if (i && std::get<0>(edges[i - 1]) == from && std::get<1>(edges[i - 1]) == to) {
+				continue;  // sorted, so the one before was cheaper
+			}
+			graph.targets.push_back(to);
+			graph.weights.push_back(weight);
+			graph.first[from + 1]++;
+		}
+		for (size_t v = 0; v < vertices; v++) {
+			graph.first[v + 1] += graph.first[v];
+		}
+		return graph;
+	}
+
+	size_t size() const {
+		return this->first.size() - 1;
+	}
+
+	size_t edges() const {
+		return this->targets.size();
+	}
+
+	std::span<const uint32_t> neighbours(size_t u) const {
+		return std::span<const uint32_t>(this->targets).subspan(this->first[u], this->first[u + 1] - this->first[u]);
+	}
+
+	// the weights of the edges to neighbours(u), in the same order
+	std::span<const size_t> weights_of(size_t u) const {
+		return std::span<const size_t>(this->weights).subspan(this->first[u], this->first[u + 1] - this->first[u]);
+	}
+
+	// v must be a neighbour of u; a binary search, weights_of() is direct
+	size_t weight(size_t u, size_t v) const {
+		auto row = this->neighbours(u);
+		auto at = std::lower_bound(row.begin(), row.end(), static_cast<uint32_t>(v));
+		assert(at != row.end() && *at == v);
+		return this->weights[this->first[u] + static_cast<size_t>(at - row.begin())];
+	}
+};
+
+/* What graph_dijkstra() found */
+struct graph_dist_t {
+	static constexpr size_t unreached = ~size_t{0};
+	static constexpr uint32_t no_parent = ~uint32_t{0};
+
+	size_t min_cost = unreached;	// to the target, if there was one
+	std::vector<size_t> dist = {};		 // cost of each vertex, or unreached
+	std::vector<uint32_t> parent = {};	 // vertex it was reached from
+	size_t expanded = 0;				 // vertices taken off the queue and expanded
+
+	graph_dist_t() {
+	}
+
+	explicit graph_dist_t(size_t vertices) : dist(vertices, unreached), parent(vertices, no_parent) {
+	}
+
+	// vertices that were reached, the sources included
+	size_t reached() const {
+		return static_cast<size_t>(std::count_if(this->dist.begin(), this->dist.end(),
+												 [](size_t d) { return d != unreached; }));
+	}
+
+	// one cheapest path, source to v, empty if v was not reached
+	std::vector<size_t> path(size_t v) const {
+		std::vector<size_t> path;
+		if (this->dist[v] == unreached) {
+			return path;
+		}
+		for (; v != no_parent; v = this->parent[v]) {
+			path.push_back(v);
+		}
+		std::reverse(path.begin(), path.end());
+		return path;
+	}
+};
+
+// graph_dijkstra() cost: the graph's own weight(u, v), or weights_of(u)
+struct graph_weight_t {
+	template <graph_c G>
+	size_t operator()(const G& graph, size_t u, size_t v) const {
+		return graph.weight(u, v);
+	}
+};
+
+// graph_dijkstra() target: none, search everything reachable
+struct graph_no_target_t {
+	bool operator()(size_t) const {
+		return false;
+	}
+};
+
+/* Dijkstra over any graph_c, from sources at cost 0, stopping at target.
+ *
+ * target is a vertex or a callable is_target(v) (e.g. any of the states of
+ * one cell). cost(graph, u, v) gives the weight of each edge, the graph's
+ * own weights by default, read from weights_of() when it has one; it is a
+ * template parameter, not a function pointer, so each call is inlined into
+ * the loop. The queue is the
+ * bucket_queue_t grid_dijkstra() uses, sized for edges up to max_weight.
+ *
+ *	auto found = graph_dijkstra(graph, {start}, end);
+ *	auto found = graph_dijkstra(graph, {start}, graph_no_target_t{},
+ *								[](const auto&, size_t, size_t) { return size_t{1}; }, 1);
+ */
+template <graph_c G, typename Target = graph_no_target_t, typename Cost = graph_weight_t>
+graph_dist_t graph_dijkstra(const G& graph,
+							const std::vector<size_t>& sources,
+							Target target = {},
+							Cost cost = {},
+							size_t max_weight = 9) {
+	auto is_target = [&target](size_t v) {
+		if constexpr (std::is_invocable_v<Target, size_t>) {
+			return target(v);
+		} else {
+			return v == static_cast<size_t>(target);
+		}
+	};
+
+	graph_dist_t result(graph.size());
+	assert(graph.size() < graph_dist_t::no_parent);
+
+	bucket_queue_t<uint32_t> Q(max_weight);
+	for (const auto source : sources) {
+		result.dist[source] = 0;
+		Q.push(0, static_cast<uint32_t>(source));
+	}
+
+	while (!Q.empty()) {
+		auto [distance, u] = Q.pop();
+		if (distance > result.dist[u]) {
+			continue;  // already reached cheaper, this entry is stale
+		}
+
+		if (is_target(u)) {
+			result.min_cost = distance;
+			break;
+		}
+		result.expanded++;
+
+		auto relax = [&](size_t v, size_t weight) {
+			const size_t neighbour_cost = distance + weight;
+			if (neighbour_cost < result.dist[v]) {
+				result.dist[v] = neighbour_cost;
+				result.parent[v] = u;
+				Q.push(neighbour_cost, static_cast<uint32_t>(v));
+			}
+		};
+
+		if constexpr (weighted_graph_c<G> && std::is_same_v<Cost, graph_weight_t>) {
+			const auto targets = graph.neighbours(u);
+			const auto weights = graph.weights_of(u);
+			for (size_t i = 0; i < std::ranges::size(targets); i++) {
+				relax(static_cast<size_t>(targets[i]), static_cast<size_t>(weights[i]));
+			}
+		} else {
+			for (const auto v : graph.neighbours(u)) {
+				relax(static_cast<size_t>(v), cost(graph, u, static_cast<size_t>(v)));
+			}
+		}
+	}
+
+	return result;
+}
+
+#endif
@@ -10,9 +10,9 @@
 #include <ranges>  // ranges and views
 #include <string>  // strings
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>  // collection
 
+#include "graph.h"	// csr_graph_t, graph_dijkstra
 #include "split.h"	// split strings
 
 using namespace std;
@@ -64,48 +64,28 @@ void print_rules(const data_t& rules) {
 	}
 }
 
-/* Inverts the rules map to show contained by relationship instead of contains.
- * bag color -> bag colors that can contain it.
- *              the number is the number of bags that can be contained.
+/* Part 1
+ * The bags that can end up holding a shiny gold bag are the ones that can be
+ * reached from it going from each bag to the bags that can contain it. The
+ * colors are numbered and the edges put in a csr_graph_t for graph_dijkstra().
  */
-data_t invert_rules(const data_t& rules) {
-	data_t irules;
+result_t part1(const data_t& rules) {
+	unordered_map<string, uint32_t> ids;
+	auto id = [&ids](const string& color) {
+		return ids.emplace(color, static_cast<uint32_t>(ids.size())).first->second;
+	};
 
+	const uint32_t start = id("shiny gold");
+	vector<csr_graph_t::edge_t> contained_by;
 	for (const auto& [color, contents] : rules) {
-		// ensure all colors exist in the inverted rules
-		if (!irules.contains(color)) {
-			irules[color] = {};
-		}
-
-		for (const auto& bag : contents) {
-			auto bag_color = bag.second;
-			irules[bag_color].push_back({bag.first, color});
+		for (const auto& [number, bag] : contents) {
+			contained_by.emplace_back(id(bag), id(color), 1);
 		}
 	}
 
-	return irules;
-}
-
-/* Return bag colors that can contain the start color bag with the given rules.
- * Recursively descends through the rules, collecting unique bag colors, for part 1.
- */
-unordered_set<string> can_contain(const data_t& rules, const string& start) {
-	unordered_set<string> bags;
-
-	for (const auto& [number, color] : rules.at(start)) {
-		bags.emplace(color);
-		bags.merge(can_contain(rules, color));
-	}
-
-	return bags;
-}
-
-/* Part 1 */
-result_t part1(const data_t& rules) {
-	// print_rules(rules);
-	auto irules = invert_rules(rules);
-	auto bags = can_contain(irules, "shiny gold");
-	return bags.size();
+	auto graph = csr_graph_t::from_edges(ids.size(), contained_by);
+	auto found = graph_dijkstra(graph, {start}, graph_no_target_t{}, graph_weight_t{}, 1);
+	return found.reached() - 1;	 // not the shiny gold bag itself
 }
 
 /* Return the number of bags the start bag must contain.
@@ -1,14 +1,224 @@
 #if !defined(SPLIT_H)
 #define SPLIT_H
 
-#include <cstring>	 // strtok, strdup
-#include <iostream>	 // cout
-#include <string>	 // std::string
-#include <vector>	 // std::vector
-
-extern std::vector<std::string> split(const std::string& str, const std::string& delims);
-extern std::vector<int> split_int(const std::string& str, const std::string& delims);
-extern std::vector<float> split_float(const std::string& str, const std::string& delims);
+#include <array>		 // std::array
+#include <cctype>		 // isdigit
+#include <charconv>		 // from_chars
+#include <cstddef>		 // ptrdiff_t
+#include <iostream>		 // cout
+#include <iterator>		 // default_sentinel_t, forward_iterator_tag
+#include <ranges>		 // view_interface
+#include <span>			 // std::span
+#include <string>		 // std::string
+#include <string_view>	 // std::string_view
+#include <type_traits>	 // is_signed_v
+#include <vector>		 // std::vector
+
+#if defined(__SSE2__)
+#include <emmintrin.h>	// SSE2, always there on x86-64
+#endif
+
+/* Lookup table of delimiter characters, one entry per byte value. */
+struct delimiters_t {
+	std::array<bool, 256> table = {};
+
+	delimiters_t(std::string_view delims) {
+		for (const char ch : delims) {
+			table[static_cast<unsigned char>(ch)] = true;
+		}
+	}
+
+	bool operator()(const char ch) const {
+		return table[static_cast<unsigned char>(ch)];
+	}
+};
+
+/* Lazy range over the tokens of a string, split on any of the delimiters.
+ * Tokens are string_views into the original string, nothing is copied or
+ * allocated, and unlike strtok it keeps no hidden state so it is safe to use
+ * from many threads at once. Empty tokens are skipped, same as strtok.
+ *
+ *	for (auto token : split_view(line, " ,")) { ... }
+ *
+ * The string must outlive the view and its iterators; do not split a
+ * temporary. Iterators carry their own copy of the delimiters, so they stay
+ * valid when the view is moved or gone.
+ */
+class split_view_t : public std::ranges::view_interface<split_view_t> {
+   public:
+	class iterator {
+	   public:
+		using iterator_concept = std::forward_iterator_tag;
+		using value_type = std::string_view;
+		using difference_type = std::ptrdiff_t;
+
+		iterator() : pos(nullptr), last(nullptr), delims(""), token() {
+		}
+
+		iterator(const char* first, const char* last, const delimiters_t& delims)
+			: pos(first), last(last), delims(delims), token() {
+			next();
+		}
+
+		std::string_view operator*() const {
+			return token;
+		}
+
+		iterator& operator++() {
+			next();
+			return *this;
+		}
+
+		iterator operator++(int) {
+			iterator previous = *this;
+			next();
+			return previous;
+		}
+
+		bool operator==(const iterator& other) const {
+			return token.data() == other.token.data();
+		}
+
+		bool operator==(std::default_sentinel_t) const {
+			return token.data() == nullptr;
+		}
+
+	   private:
+		const char* pos;
+		const char* last;
+		delimiters_t delims;
+		std::string_view token;
+
+		/* skip delimiters, then take everything up to the next one */
+		void next() {
+			while (pos != last && delims(*pos)) {
+				pos++;
+			}
+
+			if (pos == last) {
+				token = {};
+				return;
+			}
+
+			const char* start = pos;
+			while (pos != last && !delims(*pos)) {
+				pos++;
+			}
+
+			token = {start, pos};
+		}
+	};
+
+	split_view_t(std::string_view str, std::string_view delims) : str(str), delims(delims) {
+	}
+
+	iterator begin() const {
+		return {str.data(), str.data() + str.size(), delims};
+	}
+
+	std::default_sentinel_t end() const {
+		return {};
+	}
+
+   private:
+	std::string_view str;
+	delimiters_t delims;
+};
+
+inline split_view_t split_view(std::string_view str, std::string_view delims = ", =;") {
+	return {str, delims};
+}
+
+extern std::vector<std::string> split(const std::string& str, const std::string& delims = ", =;");
+extern std::vector<int> split_int(const std::string& str, const std::string& delims = ", =;");
+extern std::vector<size_t> split_size_t(const std::string& str, const std::string& delims = ", =;");
+extern std::vector<float> split_float(const std::string& str, const std::string& delims = ", =;");
+
+/* Return the first digit in [p, last), or last if there are none.
+ * Checks 16 bytes at a time where there is SSE2, so long runs of
+ * text between numbers are skipped quickly.
+ */
+inline const char* find_digit(const char* p, const char* last) {
+#if defined(__SSE2__)
+	const __m128i below = _mm_set1_epi8('0' - 1);
+	const __m128i above = _mm_set1_epi8('9' + 1);
+
+	while (last - p >= 16) {
+		__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		__m128i digits = _mm_and_si128(_mm_cmpgt_epi8(bytes, below), _mm_cmplt_epi8(bytes, above));
+		int mask = _mm_movemask_epi8(digits);
+		if (mask) {
+			return p + __builtin_ctz(static_cast<unsigned int>(mask));
+		}
+		p += 16;
+	}
+#endif
+
+	while (p != last && (*p < '0' || '9' < *p)) {
+		p++;
+	}
+
+	return p;
+}
+
+/* Call fn(n) for every integer in str, anything else is a separator.
+ * For signed T a '-' right before the digits makes the number negative,
+ * unless it follows a digit; "1-3" is the range 1 to 3, not 1 and -3.
+ */
+template <typename T, typename F>
+void for_each_int(std::string_view str, F fn) {
+	const char* first = str.data();
+	const char* last = first + str.size();
+
+	const char* p = find_digit(first, last);
+	while (p != last) {
+		const char* start = p;
+		if constexpr (std::is_signed_v<T>) {
+			if (start != first && start[-1] == '-' && (start - 1 == first || !isdigit(static_cast<unsigned char>(start[-2])))) {
+				start--;
+			}
+		}
+
+		T n = 0;
+		auto [end, ec] = std::from_chars(start, last, n);
+		if (ec == std::errc()) {
+			if (!fn(n)) {
+				return;
+			}
+		}
+
+		p = find_digit(end > p ? end : p + 1, last);
+	}
+}
+
+/* Parse the integers in str into the caller's buffer, returns how many.
+ * Stops when the buffer is full. No allocation, no temporary strings.
+ *
+ *	std::array<int, 4> numbers;
+ *	size_t n = parse_ints<int>("1-3 a: abc", numbers);	// 1, 3
+ */
+template <typename T>
+size_t parse_ints(std::string_view str, std::span<T> out) {
+	size_t count = 0;
+
+	if (!out.empty()) {
+		for_each_int<T>(str, [&out, &count](T n) {
+			out[count++] = n;
+			return count < out.size();
+		});
+	}
+
+	return count;
+}
+
+/* Parse the integers in str and append them to out, e.g. a whole file. */
+template <typename T>
+void parse_ints(std::string_view str, std::vector<T>& out) {
+	for_each_int<T>(str, [&out](T n) {
+		out.push_back(n);
+		return true;
+	});
+}
 
 template <typename T>
 std::ostream& operator<<(std::ostream& os, const std::vector<T>& v) {
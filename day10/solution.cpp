@@ -9,11 +9,13 @@
 #include <print>
 #include <ranges>  // ranges and views
 #include <string>  // strings
+#include <iterator>  // istreambuf_iterator
 #include <vector>  // collectin
 #include <set>
 #include <map>
 
 #include "mrf.h"	// map, reduce, filter templates
+#include "split.h"	// parse_ints
 
 using namespace std;
 
@@ -28,14 +30,10 @@ using duration_t = chrono::duration<double, milli>;
 const data_t read_data(const string& filename) {
 	data_t data;
 
+	// one number per line, parse the whole file in one go
 	std::ifstream ifs(filename);
-
-	string line;
-	while (getline(ifs, line)) {
-		if (!line.empty()) {
-			data.push_back(stoul(line));
-		}
-	}
+	string text{istreambuf_iterator<char>(ifs), istreambuf_iterator<char>()};
+	parse_ints<result_t>(text, data);
 
 	return data;
 }
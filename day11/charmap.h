@@ -1,12 +1,19 @@
 #if !defined(CHARMAP_T_H)
 #define CHARMAP_T_H
 
+#include <cstdlib>	// std::abs
 #include <format>
 #include <fstream>
 #include <functional>  // std::function
 #include <iterator>
+#include <memory>  // std::shared_ptr (mapped file)
 #include <ranges>  // std::flat_map
+#include <span>	   // rows
 #include <string>  // std::string
+#include <string_view>	// mapped file
+#include <tuple>	// all_xy
+#include <type_traits>	// invoke_result_t
+#include <utility>	// std::as_const
 #include <vector>  // std::vector
 
 #include "point.h"
@@ -15,61 +22,71 @@ struct charmap_t {
 	dimension_t size_x = 0;
 	dimension_t size_y = 0;
 	// size_t show_context = 0;
-	std::vector<std::vector<char>> data = {};
+
+	/* The map is one buffer of rows, `stride` chars apart, with an optional
+	 * ring of `halo` cells around it holding `border`. get() and set() are
+	 * bounds checked as before. get_unchecked() is not, and can reach
+	 * into the halo, so a 1-cell halo lets neighbour probes skip the checks.
+	 * Copying the map is a single copy of the buffer.
+	 *
+	 * A map from map_file() has no buffer of its own. It reads straight from
+	 * the mapped file, where the stride is size_x + 1 for the newline. The
+	 * first change (set(), a writable row(), ...) copies it into cells.
+	 * Copies of a mapped map share the mapping.
+	 */
+	dimension_t halo = 0;
+	dimension_t stride = 0;
+	char border = '\0';
+	std::vector<char> cells = {};
+	std::string_view mapped = {};
+	std::shared_ptr<const void> mapping = {};
 
 	charmap_t() {
 	}
 
 	// empty of size_x x size_y
 	template <std::convertible_to<dimension_t> Tx, std::convertible_to<dimension_t> Ty>
-	charmap_t(Tx size_x, Ty size_y, char fill = '\0') {
-		for (Ty y = 0; y < size_y; y++) {
-			std::vector<char> row;
-			for (Tx x = 0; x < size_x; x++) {
-				row.push_back(fill);
-			}
-
-			data.push_back(row);
-		}
-
-		this->update_size();
+	charmap_t(Tx size_x, Ty size_y, char fill = '\0')
+		: size_x(static_cast<dimension_t>(size_x)),
+		  size_y(static_cast<dimension_t>(size_y)),
+		  stride(static_cast<dimension_t>(size_x)),
+		  cells(static_cast<size_t>(this->size_x * this->size_y), fill) {
 	}
 
 	void add_line(const std::string& line) {
-		this->data.push_back({line.begin(), line.end()});
-		this->update_size();
+		this->own();
+		this->add_row(line.data(), line.size());
 	}
 
 	void add_line(const std::vector<char>& line) {
-		this->data.push_back(line);
-		this->update_size();
+		this->own();
+		this->add_row(line.data(), line.size());
 	}
 
 	void add_line(const char ch = '.') {
 		std::vector<char> charline(static_cast<size_t>(this->size_x), ch);
-		this->data.push_back(charline);
-		this->update_size();
+		this->own();
+		this->add_row(charline.data(), charline.size());
 	}
 
+	/* Rows shorter than the widest are padded with '\0' when added */
 	void fill_ragged(const char filler_ch = ' ') {
 		// if the map has ragged x edges (on the right)
 		// fill them in with empty space to make the map rectangle
-
-		// find max_x; max width row
-		size_t max_x = 0;
-		for (const auto& row : this->data) {
-			max_x = std::max(max_x, row.size());
-		}
-
-		// fill with filler_ch
-		for (auto& row : this->data) {
-			while (row.size() < max_x) {
-				row.push_back(filler_ch);
+		for (dimension_t y = 0; y < this->size_y; y++) {
+			for (auto& ch : this->row(y)) {
+				if (ch == '\0') {
+					ch = filler_ch;
+				}
 			}
 		}
+	}
 
-		// update the xsize_x of the map
-		this->size_x = static_cast<dimension_t>(max_x);
+	/* Put a ring of `width` cells of border_ch around the map */
+	void add_halo(const char border_ch = '\0', const dimension_t width = 1) {
+		this->own();
+		this->border = border_ch;
+		this->relayout(this->size_x, width);
 	}
 
 	template <std::convertible_to<dimension_t> Tx, std::convertible_to<dimension_t> Ty>
@@ -83,24 +100,37 @@ struct charmap_t {
 		return is_valid(p.x, p.y);
 	}
 
+	/* Offset of x, y in cells; valid for -halo <= x < size_x + halo (and y) */
+	template <std::convertible_to<dimension_t> Tx, std::convertible_to<dimension_t> Ty>
+	size_t index(const Tx x, const Ty y) const {
+		return static_cast<size_t>((static_cast<dimension_t>(y) + this->halo) * this->stride
+								   + static_cast<dimension_t>(x) + this->halo);
+	}
+
 	template <std::convertible_to<dimension_t> Tx, std::convertible_to<dimension_t> Ty>
 	char get(const Tx x, const Ty y, const char invalid = '\0') const {
-		size_t size_x = static_cast<size_t>(x);
-		size_t size_y = static_cast<size_t>(y);
-		return this->is_valid(x, y) ? data[size_y][size_x] : invalid;
+		return this->is_valid(x, y) ? this->cell_data()[this->index(x, y)] : invalid;
 	}
 
 	char get(const point_t& p, const char invalid = '\0') const {
 		return this->get(p.x, p.y, invalid);
 	}
 
+	template <std::convertible_to<dimension_t> Tx, std::convertible_to<dimension_t> Ty>
+	char get_unchecked(const Tx x, const Ty y) const {
+		return this->cell_data()[this->index(x, y)];
+	}
+
+	char get_unchecked(const point_t& p) const {
+		return this->get_unchecked(p.x, p.y);
+	}
+
 	template <std::convertible_to<dimension_t> Tx, std::convertible_to<dimension_t> Ty,
 			  std::convertible_to<char> Tc>
 	void set(const Tx x, const Ty y, const Tc c) {
 		if (this->is_valid(x, y)) {
-			size_t size_x = static_cast<size_t>(x);
-			size_t size_y = static_cast<size_t>(y);
-			this->data[size_y][size_x] = static_cast<char>(c);
+			this->own();
+			this->cells[this->index(x, y)] = static_cast<char>(c);
 		}
 	}
 
@@ -129,16 +159,136 @@ struct charmap_t {
 		return !this->is_char(p, c);
 	}
 
-	// std::views iterator for all x,y with character
+	/* The size_x cells of row y, -halo <= y < size_y + halo */
+	template <std::convertible_to<dimension_t> Ty>
+	std::span<char> row(const Ty y) {
+		this->own();
+		return {this->cells.data() + this->index(0, y), static_cast<size_t>(this->size_x)};
+	}
+
+	template <std::convertible_to<dimension_t> Ty>
+	std::span<const char> row(const Ty y) const {
+		return {this->cell_data() + this->index(0, y), static_cast<size_t>(this->size_x)};
+	}
+
+	// std::views iterator over the rows (no halo) as span<const char>
+	auto rows() const {
+		return std::views::iota(dimension_t{0}, this->size_y) |
+			   std::views::transform([this](dimension_t y) { return this->row(y); });
+	}
+
+	/* Random access iterator over the cells, row by row, that walks a
+	 * pointer through the buffer. Make(x, y, ch) builds the value.
+	 */
+	template <typename Make>
+	class cell_iterator_t {
+	   public:
+		using value_type = std::invoke_result_t<Make, dimension_t, dimension_t, char>;
+		using difference_type = std::ptrdiff_t;
+		using iterator_concept = std::random_access_iterator_tag;
+
+		cell_iterator_t() {
+		}
+
+		cell_iterator_t(const charmap_t* map, dimension_t x, dimension_t y)
+			: map(map), x(x), y(y), cell(y < map->size_y ? map->cell_data() + map->index(x, y) : nullptr) {
+		}
+
+		value_type operator*() const {
+			return Make{}(this->x, this->y, *this->cell);
+		}
+
+		value_type operator[](difference_type n) const {
+			return *(*this + n);
+		}
+
+		cell_iterator_t& operator++() {
+			++this->cell;
+			if (++this->x == this->map->size_x) {
+				*this = cell_iterator_t(this->map, 0, this->y + 1);
+			}
+			return *this;
+		}
+
+		cell_iterator_t operator++(int) {
+			auto old = *this;
+			++*this;
+			return old;
+		}
+
+		cell_iterator_t& operator--() {
+			return *this += -1;
+		}
+
+		cell_iterator_t operator--(int) {
+			auto old = *this;
+			--*this;
+			return old;
+		}
+
+		cell_iterator_t& operator+=(difference_type n) {
+			return *this = cell_iterator_t(this->map, this->ordinal() + n);
+		}
+
+		cell_iterator_t& operator-=(difference_type n) {
+			return *this += -n;
+		}
+
+		friend cell_iterator_t operator+(cell_iterator_t it, difference_type n) { return it += n; }
+		friend cell_iterator_t operator+(difference_type n, cell_iterator_t it) { return it += n; }
+		friend cell_iterator_t operator-(cell_iterator_t it, difference_type n) { return it -= n; }
+		friend difference_type operator-(const cell_iterator_t& a, const cell_iterator_t& b) {
+			return a.ordinal() - b.ordinal();
+		}
+
+		bool operator==(const cell_iterator_t& other) const {
+			return this->x == other.x && this->y == other.y;
+		}
+
+		auto operator<=>(const cell_iterator_t& other) const {
+			return this->ordinal() <=> other.ordinal();
+		}
+
+	   private:
+		const charmap_t* map = nullptr;
+		dimension_t x = 0;
+		dimension_t y = 0;
+		const char* cell = nullptr;
+
+		cell_iterator_t(const charmap_t* map, difference_type ordinal)
+			: cell_iterator_t(map, map->size_x ? ordinal % map->size_x : 0, map->size_x ? ordinal / map->size_x : 0) {
+		}
+
+		difference_type ordinal() const {
+			return this->y * this->map->size_x + this->x;
+		}
+	};
+
+	struct make_xy_t {
+		std::tuple<size_t, size_t, char> operator()(dimension_t x, dimension_t y, char ch) const {
+			return {static_cast<size_t>(x), static_cast<size_t>(y), ch};
+		}
+	};
+
+	struct make_point_t {
+		point_t operator()(dimension_t x, dimension_t y, char ch) const {
+			point_t p(x, y);
+			p.w = ch;
+			return p;
+		}
+	};
+
+	template <typename Make>
+	std::ranges::subrange<cell_iterator_t<Make>> all_cells() const {
+		if (this->size_x == 0) {
+			return {cell_iterator_t<Make>(this, 0, 0), cell_iterator_t<Make>(this, 0, 0)};
+		}
+		return {cell_iterator_t<Make>(this, 0, 0), cell_iterator_t<Make>(this, 0, this->size_y)};
+	}
+
+	// iterator for all x,y with character, as tuple<size_t, size_t, char>
 	auto all_xy() const {
-		return std::views::iota(0u, data.size()) |
-			   std::views::transform([this](size_t y) {
-				   return std::views::iota(0u, data[y].size()) |
-						  std::views::transform([this, y](size_t x) {
-							  return std::tuple<size_t, size_t, char>(x, y, data[y][x]);
-						  });
-			   }) |
-			   std::views::join;
+		return this->all_cells<make_xy_t>();
 	}
 
 	std::vector<point_t> _directions{{0, -1}, {1, 0}, {0, 1}, {-1, 0}};
@@ -152,19 +302,20 @@ struct charmap_t {
 			   });
 	}
 
-	// std::views iterator for all point_t with character
+	// iterator for all point_t with character in w
 	auto all_points() const {
-		return std::views::iota(0u, data.size()) |
-			   std::views::transform([this](size_t y) {
-				   return std::views::iota(0u, this->data[y].size()) |
-						  std::views::transform([this, y](size_t x) {
-							  point_t p(x, y);
-							  p.w = this->data[y][x];
-							  return p;
-							  // return std::pair<point_t, char>({x, y}, this->data[y][x]);
-						  });
-			   }) |
-			   std::views::join;
+		return this->all_cells<make_point_t>();
+	}
+
+	/* f(x, y, ch) for every cell, a plain loop per row */
+	template <typename F>
+	void for_each_cell(F&& f) const {
+		for (dimension_t y = 0; y < this->size_y; y++) {
+			const char* row = this->cell_data() + this->index(0, y);
+			for (dimension_t x = 0; x < this->size_x; x++) {
+				f(x, y, row[x]);
+			}
+		}
 	}
 
 	/* Iterate/Enumerate over all the points in the map
@@ -208,22 +359,19 @@ struct charmap_t {
 		charmap_t map;
 
 		for (const auto& line : lines) {
-			map.data.push_back({line.begin(), line.end()});
+			map.add_line(line);
 		}
 
-		map.update_size();
 		return map;
 	}
 
 	static charmap_t from_stream(std::ifstream& infile) {
 		charmap_t map;
 
-		std::string line;
 		for (std::string line; std::getline(infile, line);) {
-			map.data.push_back({line.begin(), line.end()});
+			map.add_line(line);
 		}
 
-		map.update_size();
 		return map;
 	}
 
@@ -232,6 +380,17 @@ struct charmap_t {
 		return charmap_t::from_stream(ifs);
 	}
 
+	/* Map the file rather than read it. Falls back to from_file() when
+	 * the file cannot be mapped or is not a rectangle of '\n' ended lines.
+	 * The mmap calls cost more than reading a small file, so this is for
+	 * big ones.
+	 */
+	static charmap_t map_file(const std::string& file_name);
+
+	bool is_mapped() const {
+		return this->mapped.data() != nullptr;
+	}
+
 	// TODO: How to limit this type to iterable types; vector, set, etc.
 	template <typename T>
 	static charmap_t from_points(const T& points, const char marker = '#', const char filler = '.') {
@@ -251,7 +410,7 @@ struct charmap_t {
 
 		const auto& [min, max] = bounding_box(points);
 
-		charmap_t map((size_t)abs(max.x - min.x), (size_t)abs(max.y - min.y), filler);
+		charmap_t map(std::abs(max.x - min.x), std::abs(max.y - min.y), filler);
 
 		for (const auto& point : points) {
 			map.set(point, marker);
@@ -263,11 +422,62 @@ struct charmap_t {
 	friend struct std::formatter<charmap_t>;
 
    private:
-	void update_size() {
-		this->size_y = static_cast<dimension_t>(this->data.size());
-		if (this->size_y) {
-			this->size_x = static_cast<dimension_t>(this->data[0].size());
+	const char* cell_data() const {
+		return this->is_mapped() ? this->mapped.data() : this->cells.data();
+	}
+
+	/* Copy a mapped map into cells, ready to be changed */
+	void own() {
+		if (!this->is_mapped()) {
+			return;
 		}
+
+		std::vector<char> owned;
+		owned.reserve(static_cast<size_t>(this->size_x * this->size_y));
+		for (dimension_t y = 0; y < this->size_y; y++) {
+			auto src = std::as_const(*this).row(y);
+			owned.insert(owned.end(), src.begin(), src.end());
+		}
+
+		this->stride = this->size_x;
+		this->cells = std::move(owned);
+		this->mapped = {};
+		this->mapping.reset();
+	}
+
+	/* Move the map into a buffer new_size_x wide with a new_halo ring.
+	 * New cells are '\0', the ring is border.
+	 */
+	void relayout(const dimension_t new_size_x, const dimension_t new_halo) {
+		const dimension_t new_stride = new_size_x + 2 * new_halo;
+		std::vector<char> resized(static_cast<size_t>(new_stride * (this->size_y + 2 * new_halo)), this->border);
+		for (dimension_t y = 0; y < this->size_y; y++) {
+			auto dst = resized.begin() + (y + new_halo) * new_stride + new_halo;
+			auto src = std::as_const(*this).row(y);
+			std::fill(std::copy(src.begin(), src.end(), dst), dst + new_size_x, '\0');
+		}
+
+		this->size_x = new_size_x;
+		this->halo = new_halo;
+		this->stride = new_stride;
+		this->cells = std::move(resized);
+	}
+
+	/* Append a row, widening the map if it is the longest so far */
+	void add_row(const char* line, const size_t length) {
+		if (this->size_y == 0 && this->halo == 0) {
+			this->size_x = this->stride = static_cast<dimension_t>(length);
+		} else if (static_cast<dimension_t>(length) > this->size_x) {
+			this->relayout(static_cast<dimension_t>(length), this->halo);
+		}
+
+		/* the new row goes in above the bottom of the halo */
+		const size_t halo_cells = static_cast<size_t>(this->halo * this->stride);
+		auto at = this->cells.insert(this->cells.end() - static_cast<std::ptrdiff_t>(halo_cells),
+									 static_cast<size_t>(this->stride), this->border);
+		at += this->halo;
+		std::fill(std::copy(line, line + length, at), at + this->size_x, '\0');
+		this->size_y++;
 	}
 };
 
@@ -282,7 +492,7 @@ struct std::formatter<charmap_t> {
 
 	auto format(const charmap_t& map, std::format_context& ctx) const {
 		auto out = ctx.out();
-		for (const auto& row : map.data) {
+		for (const auto row : map.rows()) {
 			for (const auto ch : row) {
 				std::format_to(out, "{}", ch);
 			}
@@ -5,6 +5,7 @@
 #include <chrono>	  // high resolution timer
 #include <cstring>	  // strtok, strdup
 #include <fstream>	  // ifstream (reading file)
+#include <future>	  // async (parallel parts)
 #include <numeric>	  // max, reduce, etc.
 #include <print>
 #include <ranges>  // ranges and views
@@ -12,6 +13,7 @@
 #include <vector>  // collectin
 
 #include "mrf.h"	// map, reduce, filter templates
+#include "bitmap.h"	// part 1 a word at a time
 #include "charmap.h"
 
 using namespace std;
@@ -25,7 +27,7 @@ using duration_t = chrono::duration<double, milli>;
 
 /* Read the data file... */
 const data_t read_data(const string& filename) {
-	return charmap_t::from_file(filename);
+	return charmap_t::map_file(filename);
 }
 
 using eval_func_t = std::function<char(const charmap_t&, const point_t&)>;
@@ -53,43 +55,26 @@ vector<point_t> directions = {
 };
 
 /* Part 1 */
-result_t count_neighbors(const charmap_t& map, const point_t& p) {
-	return reduce<point_t, result_t>(directions, 0ul, [&map, &p](result_t a, const point_t& d) {
-		return (result_t)map.is_char(p+d, '#') ? a + 1 : a;
-	});
-}
-
-char part1_next_seat(const charmap_t& map, const point_t& p) {
-	auto seat = map.get(p);
-	auto neighbors = count_neighbors(map, p);
-
-	if (seat == 'L' && neighbors == 0) {
-		return '#';
-	}
-
-	if (seat == '#' && 4 <= neighbors ) {
-		return 'L';
-	}
-
-	return seat;
+/* One round of part 1 on bitmaps of the seats and which of them are
+ * occupied: an empty seat with no occupied neighbours fills, an occupied
+ * one with 4 or more occupied neighbours empties.
+ */
+bitmap_t part1_next_occupied(const bitmap_t& seats, const bitmap_t& occupied) {
+	auto counts = occupied.neighbor_counts();
+	return seats & ((~occupied & bitmap_t::count_is(counts, 0))
+					| (occupied & ~bitmap_t::count_at_least(counts, 4)));
 }
 
 result_t part1(const data_t& data) {
-	charmap_t current = data;
-	result_t changes;
+	const bitmap_t seats = bitmap_t::from_charmap(data, 'L') | bitmap_t::from_charmap(data, '#');
+	bitmap_t occupied = bitmap_t::from_charmap(data, '#');
 
-	do {
-		auto p = next_state(current, part1_next_seat);
-		current = p.first;
-		changes = p.second;
-	} while (changes != 0);
-
-	auto seats = current.all_points() | std::views::common;
-	result_t occupied = std::accumulate(seats.begin(), seats.end(), 0ul, [](auto a, const auto& seat) {
-		return (seat.w == '#') ? a + 1 : a;
-	});
+	for (auto next = part1_next_occupied(seats, occupied); next != occupied;
+		 next = part1_next_occupied(seats, occupied)) {
+		occupied = std::move(next);
+	}
 
-	return occupied;
+	return occupied.count();
 }
 
 /* Part 2 */
@@ -134,9 +119,9 @@ result_t part2(const data_t& data) {
 		changes = p.second;
 	} while (changes != 0);
 
-	auto seats = current.all_points() | std::views::common;
-	result_t occupied = std::accumulate(seats.begin(), seats.end(), 0ul, [](auto a, const auto& seat) {
-		return (seat.w == '#') ? a + 1 : a;
+	result_t occupied = 0;
+	current.for_each_cell([&occupied](dimension_t, dimension_t, char seat) {
+		occupied += (seat == '#') ? 1 : 0;
 	});
 
 	return occupied;
@@ -144,13 +129,17 @@ result_t part2(const data_t& data) {
 
 int main(int argc, char* argv[]) {
 	bool verbose = false;
+	bool parallel = false;
 
 	int c;
-	while ((c = getopt(argc, argv, "v")) != -1) {
+	while ((c = getopt(argc, argv, "vp")) != -1) {
 		switch (c) {
 			case 'v':
 				verbose = !verbose;
 				break;
+			case 'p':
+				parallel = !parallel;
+				break;
 			default:
 				std::print(stderr, "ERROR: Unknown option \"{}\"\n", c);
 				exit(1);
@@ -176,18 +165,39 @@ int main(int argc, char* argv[]) {
 		print("{:>15} ({:>10.4f}ms)\n", "parse", parse_time.count());
 	}
 
-	result_t p1_result = part1(data);
+	/* Run one part on the data, returning its result and how long it took. */
+	auto run_part = [&data](auto part) -> pair<result_t, duration_t> {
+		auto part_start = chrono::high_resolution_clock::now();
+		result_t result = part(data);
+		duration_t part_time = chrono::high_resolution_clock::now() - part_start;
+		return {result, part_time};
+	};
 
-	auto p1_complete = chrono::high_resolution_clock::now();
-	duration_t p1_time = p1_complete - parse_complete;
-	print("{:>15} ({:>10.4f}ms){}", p1_result, p1_time.count(), verbose ? "\n" : "");
+	pair<result_t, duration_t> p1, p2;
+	if (parallel) {
+		// both parts only read data, so each can run on its own thread
+		auto p1_future = async(launch::async, run_part, part1);
+		auto p2_future = async(launch::async, run_part, part2);
+		p1 = p1_future.get();
+		p2 = p2_future.get();
+	} else {
+		p1 = run_part(part1);
+		p2 = run_part(part2);
+	}
+
+	auto parts_complete = chrono::high_resolution_clock::now();
 
-	result_t p2_result = part2(data);
+	auto [p1_result, p1_time] = p1;
+	print("{:>15} ({:>10.4f}ms){}", p1_result, p1_time.count(), verbose ? "\n" : "");
 
-	auto p2_complete = chrono::high_resolution_clock::now();
-	duration_t p2_time = p2_complete - p1_complete;
+	auto [p2_result, p2_time] = p2;
 	print("{:>15} ({:>10.4f}ms){}", p2_result, p2_time.count(), verbose ? "\n" : "");
 
-	duration_t total_time = p2_complete - start_time;
+	if (verbose) {
+		duration_t wall_time = parts_complete - parse_complete;
+		print("{:>15} ({:>10.4f}ms)\n", parallel ? "parallel" : "sequential", wall_time.count());
+	}
+
+	duration_t total_time = parts_complete - start_time;
 	print("{:>15} ({:>10.4f}ms)\n", "total", total_time.count());
 }
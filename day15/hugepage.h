@@ -0,0 +1,63 @@
+#if !defined(HUGEPAGE_H)
+#define HUGEPAGE_H
+
+#include <cstddef>	// size_t
+#include <limits>	// numeric_limits
+#include <new>		// operator new, bad_alloc, bad_array_new_length
+
+/* Allocations at least this big are backed by huge pages (2MB on x86-64). */
+constexpr size_t huge_page_size = 2 * 1024 * 1024;
+
+extern void* huge_page_alloc(size_t bytes);
+extern void huge_page_free(void* ptr, size_t bytes);
+
+/* Allocator for big flat tables (e.g. vector<size_t>(30000000)) that are
+ * hit at random. Backing them with huge pages cuts the TLB misses.
+ *
+ * Small allocations go through the normal operator new, so this is safe to
+ * use for any vector; only tables of huge_page_size or more are mmap'd.
+ * Falls back to normal pages when huge pages are not available.
+ *
+ *	vector<size_t, huge_page_allocator_t<size_t>> table(30000000);
+ */
+template <typename T>
+struct huge_page_allocator_t {
+	using value_type = T;
+
+	huge_page_allocator_t() noexcept {}
+
+	template <typename U>
+	huge_page_allocator_t(const huge_page_allocator_t<U>&) noexcept {}
+
+	T* allocate(size_t n) {
+		// as std::allocator does, rather than wrap to a small allocation
+		if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+			throw std::bad_array_new_length();
+		}
+
+		size_t bytes = n * sizeof(T);
+		if (bytes < huge_page_size) {
+			return static_cast<T*>(::operator new(bytes));
+		}
+
+		return static_cast<T*>(huge_page_alloc(bytes));
+	}
+
+	// n is what allocate() was given, so n * sizeof(T) did not overflow there
+	void deallocate(T* ptr, size_t n) noexcept {
+		size_t bytes = n * sizeof(T);
+		if (bytes < huge_page_size) {
+			::operator delete(ptr);
+			return;
+		}
+
+		huge_page_free(ptr, bytes);
+	}
+
+	template <typename U>
+	bool operator==(const huge_page_allocator_t<U>&) const noexcept {
+		return true;
+	}
+};
+
+#endif
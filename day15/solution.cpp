@@ -5,6 +5,7 @@
 #include <chrono>	  // high resolution timer
 #include <cstring>	  // strtok, strdup
 #include <fstream>	  // ifstream (reading file)
+#include <future>	  // async (parallel parts)
 #include <numeric>	  // max, reduce, etc.
 #include <print>
 #include <ranges>  // ranges and views
@@ -12,6 +13,7 @@
 #include <vector>  // collectin
 #include <unordered_map>
 
+#include "hugepage.h"	// huge page backed tables
 #include "mrf.h"	// map, reduce, filter templates
 #include "split.h"	// split strings
 
@@ -173,22 +175,52 @@ size_t spoken_number3(const data_t& seed, const size_t turns) {
 	return last;
 }
 
+// same as spoken_number3, with the tables backed by huge pages.
+// the random hits into 30M entries are bound by TLB misses, not the math.
+size_t spoken_number4(const data_t& seed, const size_t turns) {
+	vector<size_t, huge_page_allocator_t<size_t>> last_spoken(turns);
+	vector<bool, huge_page_allocator_t<bool>> is_valid(turns);
+
+	size_t last = 0;
+	for (size_t turn = 0; turn < turns; turn++) {
+		size_t next = 0;
+		if (turn < seed.size()) {
+			next = seed[turn];
+		} else if (is_valid[last]) {
+			next = turn - last_spoken[last];
+		}
+
+		if (turn != 0) {
+			last_spoken[last] = turn;
+			is_valid[last] = true;
+		}
+
+		last = next;
+	}
+
+	return last;
+}
+
 result_t part1(const data_t& data) {
-	return spoken_number3(data, 2020);
+	return spoken_number4(data, 2020);
 }
 /* Part 2*/
 result_t part2(const data_t& data) {
-	return spoken_number3(data, 30000000);
+	return spoken_number4(data, 30000000);
 }
 
 int main(int argc, char* argv[]) {
+	bool parallel = false;
 
 	int c;
-	while ((c = getopt(argc, argv, "v")) != -1) {
+	while ((c = getopt(argc, argv, "vp")) != -1) {
 		switch (c) {
 			case 'v':
 				verbose = !verbose;
 				break;
+			case 'p':
+				parallel = !parallel;
+				break;
 			default:
 				std::print(stderr, "ERROR: Unknown option \"{}\"\n", c);
 				exit(1);
@@ -214,18 +246,39 @@ int main(int argc, char* argv[]) {
 		print("{:>15} ({:>10.4f}ms)\n", "parse", parse_time.count());
 	}
 
-	result_t p1_result = part1(data);
+	/* Run one part on the data, returning its result and how long it took. */
+	auto run_part = [&data](auto part) -> pair<result_t, duration_t> {
+		auto part_start = chrono::high_resolution_clock::now();
+		result_t result = part(data);
+		duration_t part_time = chrono::high_resolution_clock::now() - part_start;
+		return {result, part_time};
+	};
+
+	pair<result_t, duration_t> p1, p2;
+	if (parallel) {
+		// both parts only read data, so each can run on its own thread
+		auto p1_future = async(launch::async, run_part, part1);
+		auto p2_future = async(launch::async, run_part, part2);
+		p1 = p1_future.get();
+		p2 = p2_future.get();
+	} else {
+		p1 = run_part(part1);
+		p2 = run_part(part2);
+	}
 
-	auto p1_complete = chrono::high_resolution_clock::now();
-	duration_t p1_time = p1_complete - parse_complete;
-	print("{:>15} ({:>10.4f}ms){}", p1_result, p1_time.count(), verbose ? "\n" : "");
+	auto parts_complete = chrono::high_resolution_clock::now();
 
-	result_t p2_result = part2(data);
+	auto [p1_result, p1_time] = p1;
+	print("{:>15} ({:>10.4f}ms){}", p1_result, p1_time.count(), verbose ? "\n" : "");
 
-	auto p2_complete = chrono::high_resolution_clock::now();
-	duration_t p2_time = p2_complete - p1_complete;
+	auto [p2_result, p2_time] = p2;
 	print("{:>15} ({:>10.4f}ms){}", p2_result, p2_time.count(), verbose ? "\n" : "");
 
-	duration_t total_time = p2_complete - start_time;
+	if (verbose) {
+		duration_t wall_time = parts_complete - parse_complete;
+		print("{:>15} ({:>10.4f}ms)\n", parallel ? "parallel" : "sequential", wall_time.count());
+	}
+
+	duration_t total_time = parts_complete - start_time;
 	print("{:>15} ({:>10.4f}ms)\n", "total", total_time.count());
 }
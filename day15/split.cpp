@@ -1,33 +1,28 @@
 #include "split.h"
 
-#include <cstring>	 // strtok, strdup
+#include <charconv>	 // from_chars
 #include <fstream>	 // ifstream (reading file)
 #include <iostream>	 // cout
-#include <ranges>
 
 using namespace std;
 
 std::vector<std::string> split(const std::string& str, const std::string& delims) {
 	std::vector<std::string> tokens;
-	char* str_c{strdup(str.c_str())};
-	char* token{NULL};
 
-	token = strtok(str_c, delims.c_str());
-	while (token != NULL) {
-		tokens.push_back(token);
-		token = strtok(NULL, delims.c_str());
+	for (const auto token : split_view(str, delims)) {
+		tokens.emplace_back(token);
 	}
 
-	free(str_c);
 	return tokens;
 }
 
 std::vector<float> split_float(const std::string& str, const std::string& delims) {
 	std::vector<float> numbers;
 
-	for (const auto& s : split(str, delims)) {
+	for (const auto s : split_view(str, delims)) {
 		if (isdigit(s[0]) || s[0] == '-') {
-			numbers.push_back(std::stof(s));
+			// no from_chars for float in libc++ yet
+			numbers.push_back(std::stof(std::string(s)));
 		}
 	}
 
@@ -37,9 +32,12 @@ std::vector<float> split_float(const std::string& str, const std::string& delims
 std::vector<int> split_int(const std::string& str, const std::string& delims) {
 	std::vector<int> numbers;
 
-	for (const auto& s : split(str, delims)) {
+	for (const auto s : split_view(str, delims)) {
 		if (isdigit(s[0]) || s[0] == '-') {
-			numbers.push_back(std::stoi(s));
+			int n = 0;
+			if (std::from_chars(s.data(), s.data() + s.size(), n).ec == std::errc()) {
+				numbers.push_back(n);
+			}
 		}
 	}
 
@@ -49,42 +47,18 @@ std::vector<int> split_int(const std::string& str, const std::string& delims) {
 std::vector<size_t> split_size_t(const std::string& str, const std::string& delims) {
 	std::vector<size_t> numbers;
 
-	for (const auto& s : split(str, delims)) {
+	for (const auto s : split_view(str, delims)) {
 		if (isdigit(s[0])) {
-			numbers.push_back(std::stoul(s));
+			size_t n = 0;
+			if (std::from_chars(s.data(), s.data() + s.size(), n).ec == std::errc()) {
+				numbers.push_back(n);
+			}
 		}
 	}
 
 	return numbers;
 }
 
-std::vector<int> split_int_2(const std::string& str, const std::string& delims) {
-	std::vector<int> numbers;
-
-	auto strings = split(str, delims);
-	std::for_each(strings.begin(), strings.end(), [&numbers](const std::string& s) {
-		if (isdigit(s[0]) || s[0] == '-') {
-			numbers.push_back(std::stoi(s));
-		}
-	});
-
-	return numbers;
-}
-
-std::vector<int> split_int_3(const std::string& str, const std::string& delims) {
-	auto strings = split(str, delims);
-	auto numbers = strings |
-				   std::views::filter([](const std::string& s) {
-					   return isdigit(s[0]) || s[0] == '-';
-				   }) |
-				   std::views::transform([](const std::string& s) {
-					   return std::stoi(s);
-				   }) |
-				   std::ranges::to<std::vector<int>>();
-
-	return numbers;
-}
-
 void test_split() {
 	cout << "Testing split functions..." << endl;
 
@@ -85,7 +85,7 @@ const data_t read_data(const string& filename) {
 						data.fields.emplace_back(parse_field(line));
 						break;
 					default:
-						data.tickets.emplace_back(split_size_t(line));
+						parse_ints<size_t>(line, data.tickets.emplace_back());
 						break;
 				}
 			}
@@ -120,10 +120,9 @@ result_t part1(const data_t& data) {
 
 	auto invalid_numbers = tickets
 		| views::transform(invalid_ticket_numbers)	// to invalid numbers
-		| views::join								// flatten to 1D
-		| ranges::to<vector<size_t>>();
+		| views::join;								// flatten to 1D
 
-	return reduce<size_t, size_t>(invalid_numbers, 0ul, std::plus<size_t>());
+	return from(invalid_numbers) | sum();
 }
 
 /* Part 2*/
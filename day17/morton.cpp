@@ -0,0 +1,43 @@
+#include "morton.h"
+
+#include <cassert>
+
+static constexpr uint64_t morton_bias = 1ul << 15;
+
+/* Spread the low 16 bits of v out to every 4th bit. */
+static uint64_t spread_bits(uint64_t v) {
+	v &= 0xFFFF;
+	v = (v | (v << 24)) & 0x000000FF000000FF;
+	v = (v | (v << 12)) & 0x000F000F000F000F;
+	v = (v | (v << 6)) & 0x0303030303030303;
+	v = (v | (v << 3)) & 0x1111111111111111;
+	return v;
+}
+
+/* Gather every 4th bit back into the low 16 bits, undoes spread_bits(). */
+static uint64_t compact_bits(uint64_t v) {
+	v &= 0x1111111111111111;
+	v = (v | (v >> 3)) & 0x0303030303030303;
+	v = (v | (v >> 6)) & 0x000F000F000F000F;
+	v = (v | (v >> 12)) & 0x000000FF000000FF;
+	v = (v | (v >> 24)) & 0xFFFF;
+	return v;
+}
+
+morton_t morton_encode(const point_t& p) {
+	// outside the 16 bits each gets, a coordinate would wrap onto another point
+	assert(morton_min <= p.x && p.x <= morton_max && morton_min <= p.y && p.y <= morton_max);
+	assert(morton_min <= p.z && p.z <= morton_max && morton_min <= p.w && p.w <= morton_max);
+	return spread_bits(static_cast<uint64_t>(p.x) + morton_bias)
+		 | spread_bits(static_cast<uint64_t>(p.y) + morton_bias) << 1
+		 | spread_bits(static_cast<uint64_t>(p.z) + morton_bias) << 2
+		 | spread_bits(static_cast<uint64_t>(p.w) + morton_bias) << 3;
+}
+
+point_t morton_decode(const morton_t key) {
+	auto coordinate = [key](int shift) {
+		return static_cast<dimension_t>(compact_bits(key >> shift)) - static_cast<dimension_t>(morton_bias);
+	};
+
+	return {coordinate(0), coordinate(1), coordinate(2), coordinate(3)};
+}
@@ -1,90 +1,125 @@
 #if !defined(POINT_T_H)
 #define POINT_T_H
 
+#include <algorithm>	 // min
+#include <cassert>
+#include <charconv>	 // from_chars
 #include <concepts>
+#include <cstddef>	 // size_t
+#include <cstdint>	 // int32_t, int16_t for the small points
+#include <format>
 #include <iomanip>	 // setw and setprecision on output
 #include <iostream>	 // cout
 #include <string>	 // std::string
 #include <tuple>
 #include <vector>
-#include <cassert>
 
 using dimension_t = long;
 using value_t = long;
 
-struct point_t {
-	dimension_t x = 0;
-	dimension_t y = 0;
-	dimension_t z = 0;
+/* The named coordinates of a point<N, T>, and nothing else, so
+ * point<2, int32_t> is 8 bytes and point<3, int16_t> is 6.
+ * axis(i) is the i'th coordinate, for loops over all N of them. It is a
+ * chain of compares rather than a table so the loops unroll to plain
+ * field accesses.
+ */
+template <size_t N, typename T>
+struct point_axes_t;
+
+template <typename T>
+struct point_axes_t<2, T> {
+	T x = 0;
+	T y = 0;
+
+	constexpr T& axis(size_t i) { return i == 0 ? x : y; }
+	constexpr const T& axis(size_t i) const { return i == 0 ? x : y; }
+};
 
-	bool feature_z_sort = false;	// true=sort by z,y,x, false=x,y,z
+template <typename T>
+struct point_axes_t<3, T> {
+	T x = 0;
+	T y = 0;
+	T z = 0;
 
-	// value_t u = 0;
-	// value_t v = 0;
-	value_t w = 0;
+	constexpr T& axis(size_t i) { return i == 0 ? x : i == 1 ? y : z; }
+	constexpr const T& axis(size_t i) const { return i == 0 ? x : i == 1 ? y : z; }
+};
+
+template <typename T>
+struct point_axes_t<4, T> {
+	T x = 0;
+	T y = 0;
+	T z = 0;
+	T w = 0;
+
+	constexpr T& axis(size_t i) { return i == 0 ? x : i == 1 ? y : i == 2 ? z : w; }
+	constexpr const T& axis(size_t i) const { return i == 0 ? x : i == 1 ? y : i == 2 ? z : w; }
+};
 
-	point_t() {}
+/* A point (or offset) with N coordinates of type T, 2 <= N <= 4.
+ *
+ * The sort order is not part of the point. operator< is x, then y, ...;
+ * sets and maps that need another order take one of the comparators below,
+ * e.g. std::set<point<3, int16_t>, point_less_zyx_t>.
+ *
+ * point_t, the long x, y, z, w point the library and days use, is
+ * point<4, dimension_t>.
+ */
+template <size_t N, typename T>
+struct point : point_axes_t<N, T> {
+	using value_type = T;
+	static constexpr size_t dimensions = N;
+
+	constexpr point() {}
 
 	/* Use templates for constructor so I don't have to worry about
-	 * mixing int and unsigned int, size_t, etc. on creation. */
-	template <std::convertible_to<dimension_t> Tx, std::convertible_to<dimension_t> Ty>
-	point_t(Tx x, Ty y, Tx z, Tx w) : x(static_cast<dimension_t>(x)),
-									  y(static_cast<dimension_t>(y)),
-									  z(static_cast<dimension_t>(z)),
-									  w(static_cast<dimension_t>(w)) {
+	 * mixing int and unsigned int, size_t, etc. on creation.
+	 * Coordinates not given are 0.
+	 */
+	template <std::convertible_to<T>... Ts>
+		requires(2 <= sizeof...(Ts) && sizeof...(Ts) <= N)
+	constexpr point(Ts... values) {
+		size_t i = 0;
+		((this->axis(i++) = static_cast<T>(values)), ...);
 	}
 
-	template <std::convertible_to<dimension_t> Tx, std::convertible_to<dimension_t> Ty>
-	point_t(Tx x, Ty y, Tx z) : x(static_cast<dimension_t>(x)),
-								y(static_cast<dimension_t>(y)),
-								z(static_cast<dimension_t>(z)) {
+	template <std::convertible_to<T> Tx, std::convertible_to<T> Ty>
+	constexpr point(const std::pair<Tx, Ty>& p) : point(p.first, p.second) {
 	}
-	template <std::convertible_to<dimension_t> Tx, std::convertible_to<dimension_t> Ty>
-	point_t(Tx x, Ty y) : x(static_cast<dimension_t>(x)),
-						  y(static_cast<dimension_t>(y)),
-						  z(0),
-						  w(0) {
+
+	template <std::convertible_to<T> U>
+	point(const std::vector<U>& v) {
+		for (size_t i = 0; i < std::min(N, v.size()); i++) {
+			(*this)[i] = static_cast<T>(v[i]);
+		}
 	}
 
-	point_t(const point_t& p) : x(static_cast<dimension_t>(p.x)),
-								y(static_cast<dimension_t>(p.y)),
-								z(static_cast<dimension_t>(p.z)),
-								// u(static_cast<dimension_t>(p.u)),
-								// v(static_cast<dimension_t>(p.v)),
-								w(static_cast<dimension_t>(p.w)) {
+	/* From a point of another size or type: the coordinates both have */
+	template <size_t M, typename U>
+		requires(M != N || !std::same_as<T, U>)
+	constexpr explicit point(const point<M, U>& p) {
+		for (size_t i = 0; i < std::min(N, M); i++) {
+			(*this)[i] = static_cast<T>(p[i]);
+		}
 	}
 
-	template <std::convertible_to<dimension_t> Tx, std::convertible_to<dimension_t> Ty>
-	point_t(const std::pair<Tx, Ty>& p) : x(static_cast<dimension_t>(p.first)),
-										  y(static_cast<dimension_t>(p.second)),
-										  z(0) {
+	constexpr T& operator[](size_t i) {
+		return this->axis(i);
 	}
 
-	template <std::convertible_to<dimension_t> T>
-	point_t(const std::vector<T>& v) {
-		if (v.size() > 0) {
-			this->x = static_cast<dimension_t>(v[0]);
-			if (v.size() > 1) {
-				this->y = static_cast<dimension_t>(v[1]);
-				if (v.size() > 2) {
-					this->z = static_cast<dimension_t>(v[2]);
-					if (v.size() > 3) {
-						this->w = static_cast<dimension_t>(v[3]);
-					}
-				}
-			}
-		}
+	constexpr const T& operator[](size_t i) const {
+		return this->axis(i);
 	}
 
-	/* Rotate point left (counter-clockwise) around origin in increments of 90-degrees 
+	/* Rotate point left (counter-clockwise) around origin in increments of 90-degrees
 	 * Currently only tested with 90, 180, and 270 degrees (e.g. charmap_t things)
 	 */
-	void rotate_left(dimension_t angle) {
+	constexpr void rotate_left(dimension_t angle) {
 		// only works with 90 degree increments
 		assert(angle == 90 || angle == 180 || angle == 270);
 
-		auto next_x = x;
-		auto next_y = y;
+		auto next_x = this->x;
+		auto next_y = this->y;
 		while (angle > 0) {
 			auto temp = next_x;
 			next_x = -next_y;
@@ -98,94 +133,60 @@ struct point_t {
 
 	/* Rotate point right (clockwise) around origin in increments of 90-degrees
 	 */
-	void rotate_right(dimension_t angle) {
+	constexpr void rotate_right(dimension_t angle) {
 		this->rotate_left(360 - angle);
 	}
 
-	bool operator<(const point_t& rhs) const {
-		if (feature_z_sort) {
-			// sorts by z, then y, then x
-			if (z == rhs.z) {
-				if (y == rhs.y) {
-					return x < rhs.x;
-				}
+	constexpr bool operator<(const point& rhs) const;
 
-				return y < rhs.y;
+	constexpr bool operator==(const point& other) const {
+		for (size_t i = 0; i < N; i++) {
+			if ((*this)[i] != other[i]) {
+				return false;
 			}
-			
-			return z < rhs.z;
 		}
-
-		// sorts by y, then x (default)
-		if (x == rhs.x) {
-			if (y == rhs.y) {
-				if (z == rhs.z) {
-					return w < rhs.w;
-				}
-
-				return z < rhs.z;
-			}
-
-			return y < rhs.y;
-		}
-
-		return x < rhs.x;
-	}
-
-	bool operator==(const point_t& other) const {
-		return this->x == other.x 
-			&& this->y == other.y 
-			&& this->z == other.z
-			&& this->w == other.w;
+		return true;
 	}
 
-	bool operator!=(const point_t& other) const {
-		return !(*this == other);
-	}
-
-	point_t& operator=(const point_t& other) {
-		this->x = other.x;
-		this->y = other.y;
-		this->z = other.z;
-		// this->u = other.u;
-		// this->v = other.v;
-		this->w = other.w;
-		return *this;
-	}
-
-	point_t& operator+=(const point_t& rhs) {
-		this->x += rhs.x;
-		this->y += rhs.y;
-		this->z += rhs.z;
-		// this->u += rhs.u;
-		// this->v += rhs.v;
-		this->w += rhs.w;
+	constexpr point& operator+=(const point& rhs) {
+		for (size_t i = 0; i < N; i++) {
+			(*this)[i] = static_cast<T>((*this)[i] + rhs[i]);
+		}
 		return *this;
 	}
 
 	// friends defined inside class body are inline and are hidden from non-ADL lookup
-	friend point_t operator+(point_t lhs, const point_t& rhs) {
+	friend constexpr point operator+(point lhs, const point& rhs) {
 		lhs += rhs;	 // reuse compound assignment
 		return lhs;	 // return the result by value (uses move constructor)
 	}
 
-	point_t& operator-=(const point_t& rhs) {
-		this->x -= rhs.x;
-		this->y -= rhs.y;
-		this->z -= rhs.z;
-		// this->u -= rhs.u;
-		// this->v -= rhs.v;
-		this->w -= rhs.w;
+	constexpr point& operator-=(const point& rhs) {
+		for (size_t i = 0; i < N; i++) {
+			(*this)[i] = static_cast<T>((*this)[i] - rhs[i]);
+		}
 		return *this;
 	}
 
 	// friends defined inside class body are inline and are hidden from non-ADL lookup
-	friend point_t operator-(point_t lhs, const point_t& rhs) {
+	friend constexpr point operator-(point lhs, const point& rhs) {
 		lhs -= rhs;	 // reuse compound assignment
 		return lhs;	 // return the result by value (uses move constructor)
 	}
 
-	static point_t from_string(const std::string& str) {
+	constexpr point& operator*=(const T scale) {
+		for (size_t i = 0; i < N; i++) {
+			(*this)[i] = static_cast<T>((*this)[i] * scale);
+		}
+		return *this;
+	}
+
+	friend constexpr point operator*(point lhs, const T scale) {
+		lhs *= scale;
+		return lhs;
+	}
+
+	static point from_string(const std::string& str) {
 		auto split_numbers = [](const std::string& str) {
 			const std::string digits{"-0123456789"};
 			std::vector<long> result;
@@ -193,7 +194,9 @@ struct point_t {
 			size_t start = str.find_first_of(digits, 0);
 			size_t end = str.find_first_not_of(digits, start);
 			while (start != std::string::npos) {
-				result.push_back(std::stol(str.substr(start)));
+				long n = 0;
+				std::from_chars(str.data() + start, str.data() + str.size(), n);
+				result.push_back(n);
 
 				start = str.find_first_of(digits, end);
 				end = str.find_first_not_of(digits, start);
@@ -204,41 +207,93 @@ struct point_t {
 
 		return {split_numbers(str)};
 	}
+};
 
-	friend struct std::formatter<point_t>;
+/* Orders for points as policy types, for the comparator of a set or map.
+ * point_less_xyz_t compares x first (operator<), point_less_zyx_t the last
+ * coordinate first, which for 2D points is reading order (y, then x).
+ */
+struct point_less_xyz_t {
+	template <size_t N, typename T>
+	constexpr bool operator()(const point<N, T>& a, const point<N, T>& b) const {
+		for (size_t i = 0; i < N; i++) {
+			if (a[i] != b[i]) {
+				return a[i] < b[i];
+			}
+		}
+		return false;
+	}
 };
 
+struct point_less_zyx_t {
+	template <size_t N, typename T>
+	constexpr bool operator()(const point<N, T>& a, const point<N, T>& b) const {
+		for (size_t i = N; i-- > 0;) {
+			if (a[i] != b[i]) {
+				return a[i] < b[i];
+			}
+		}
+		return false;
+	}
+};
+
+template <size_t N, typename T>
+constexpr bool point<N, T>::operator<(const point& rhs) const {
+	return point_less_xyz_t{}(*this, rhs);
+}
+
+using point_t = point<4, dimension_t>;
+
+static_assert(sizeof(point<2, int32_t>) == 8);
+static_assert(sizeof(point<3, int16_t>) == 6);
+static_assert(sizeof(point_t) == 4 * sizeof(dimension_t));
+
 std::ostream& operator<<(std::ostream& os, const point_t& p);
 std::ostream& operator<<(std::ostream& os, const std::vector<point_t>& v);
 std::istream& operator>>(std::istream& is, point_t& p);
 
-/* hash function so can be put in unordered_map or set */
-template <>
-struct std::hash<point_t> {
-	size_t operator()(const point_t& p) const {
-		return std::hash<size_t>()(
-			  (((size_t)p.w & 0xFFFF) << 48)
-			| (((size_t)p.z & 0xFFFF) << 32) 
-			| (((size_t)p.x & 0xFFFF) << 24) 
-			| (((size_t)p.y & 0xFFFF)));
+/* Mix the bits of a 64 bit key so every input bit affects every output bit
+ * (splitmix64's finalizer). Bucket and slot indexes can then be taken from
+ * any of the bits, low ones included.
+ */
+constexpr uint64_t hash_mix(uint64_t h) {
+	h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+	h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+	return h ^ (h >> 31);
+}
+
+/* Add value into a running hash, hash_mix() the total when done */
+constexpr uint64_t hash_combine(uint64_t h, uint64_t value) {
+	return (h + value) * 0x9e3779b97f4a7c15ull;
+}
+
+/* hash function so can be put in unordered_map or set. Every bit of every
+ * coordinate counts, negative ones included.
+ */
+template <size_t N, typename T>
+struct std::hash<point<N, T>> {
+	size_t operator()(const point<N, T>& p) const {
+		uint64_t h = 0;
+		for (size_t i = 0; i < N; i++) {
+			h = hash_combine(h, static_cast<uint64_t>(p[i]));
+		}
+		return hash_mix(h);
 	}
 };
 
-template <>
-struct std::formatter<point_t> {
+template <size_t N, typename T>
+struct std::formatter<point<N, T>> {
 	constexpr auto parse(std::format_parse_context& context) {
 		return context.begin();
 	}
 
-	auto format(const point_t& p, std::format_context& context) const {
+	// (x,y) and then z, w as long as they are not 0
+	auto format(const point<N, T>& p, std::format_context& context) const {
 		auto out = context.out();
 
 		std::format_to(out, "({},{}", p.x, p.y);
-		if (p.z) {
-			std::format_to(out, ",{}", p.z);
-			if (p.w) {
-				std::format_to(out, ",{}", p.w);
-			}
+		for (size_t i = 2; i < N && p[i]; i++) {
+			std::format_to(out, ",{}", p[i]);
 		}
 		std::format_to(out, ")");
 
@@ -246,17 +301,16 @@ struct std::formatter<point_t> {
 	}
 };
 
-inline dimension_t manhattan_distance(const point_t& p1, const point_t& p2) {
-	dimension_t dx = p1.x > p2.x ? p1.x - p2.x : p2.x - p1.x;
-	dimension_t dy = p1.y > p2.y ? p1.y - p2.y : p2.y - p1.y;
-	dimension_t dz = p1.z > p2.z ? p1.z - p2.z : p2.z - p1.z;
-	// dimension_t du = p1.u > p2.u ? p1.u - p2.u : p2.u - p1.u;
-	// dimension_t dv = p1.v > p2.v ? p1.v - p2.v : p2.v - p1.v;
-	dimension_t dw = p1.w > p2.w ? p1.w - p2.w : p2.w - p1.w;
-	return dx + dy + dz + dw;
+template <size_t N, typename T>
+constexpr T manhattan_distance(const point<N, T>& p1, const point<N, T>& p2) {
+	T distance = 0;
+	for (size_t i = 0; i < N; i++) {
+		distance = static_cast<T>(distance + (p1[i] > p2[i] ? p1[i] - p2[i] : p2[i] - p1[i]));
+	}
+	return distance;
 }
 
 // read points until we hit an empty line
 std::vector<point_t> read_points(std::istream& is, void (*fn)(point_t& point, const std::string& line) = nullptr);
 
-#endif
\ No newline at end of file
+#endif
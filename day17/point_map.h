@@ -0,0 +1,394 @@
+#if !defined(POINT_MAP_T_H)
+#define POINT_MAP_T_H
+
+#include <algorithm>	// max
+#include <cstddef>		// size_t
+#include <cstdint>		// uint64_t, uint8_t
+#include <iterator>		// forward_iterator_tag
+#include <type_traits>	// conditional_t
+#include <utility>		// swap, pair
+#include <vector>		// std::vector
+
+#include "point.h"
+
+/* Open addressing hash map from point<N, T> to V, point_set_t when there is
+ * no value. One flat array, no node per entry, for the sets of cells the
+ * cellular automata (day17, day24) build and probe every generation.
+ *
+ * Points whose coordinates fit in 64 bits (point<2, int32_t>,
+ * point<4, int16_t>, ...) are stored packed into one word, so a probe is a
+ * single compare and the hash is one hash_mix(). Bigger points (point_t) are
+ * stored as they are and hashed with std::hash.
+ *
+ * Slots are Robin Hood linear probed: each slot keeps its distance from
+ * home + 1 (0 is empty), an insert takes the slot of any entry nearer home
+ * than itself, a lookup stops at the first entry nearer home than the key
+ * would be, and an erase shifts the run after it back. The table doubles
+ * when it is half full; letting it get to 3/4 full made lookups in day17's
+ * sets take nearly twice as long. probe_stats() reports the probe lengths.
+ *
+ *	point_set_t<point<2, int32_t>> active;
+ *	active.insert({3, -4});
+ *	if (active.contains(p)) ...
+ *
+ *	point_map_t<point_t, size_t> counts;
+ *	counts[p]++;
+ */
+template <typename P = point_t, typename V = void>
+struct point_map_t {
+	static constexpr bool is_set = std::is_void_v<V>;
+	static constexpr bool packed = P::dimensions * sizeof(typename P::value_type) <= sizeof(uint64_t);
+
+	using point_type = P;
+	using key_t = std::conditional_t<packed, uint64_t, P>;
+	using value_t = std::conditional_t<is_set, char, V>;
+
+	point_map_t() {
+	}
+
+	explicit point_map_t(size_t expected) {
+		this->reserve(expected);
+	}
+
+	template <typename It>
+	point_map_t(It first, It last) {
+		for (; first != last; ++first) {
+			this->insert(*first);
+		}
+	}
+
+	size_t size() const {
+		return this->count;
+	}
+
+	bool empty() const {
+		return this->count == 0;
+	}
+
+	void clear() {
+		std::fill(this->dist.begin(), this->dist.end(), uint8_t{0});
+		this->count = 0;
+	}
+
+	/* Room for n entries without growing */
+	void reserve(size_t n) {
+		size_t capacity = 16;
+		while (capacity / 2 < n) {
+			capacity *= 2;
+		}
+		if (capacity > this->dist.size()) {
+			this->rehash(capacity);
+		}
+	}
+
+	bool contains(const P& p) const {
+		return this->find_slot(pack(p)) != npos;
+	}
+
+	/* Insert p (set), returns true if it was not there already */
+	bool insert(const P& p)
+		requires is_set
+	{
+		size_t before = this->count;
+		this->emplace_slot(pack(p));
+		return this->count != before;
+	}
+
+	/* Insert p with value v if p is not there yet (map) */
+	bool insert(const P& p, const value_t& v)
+		requires(!is_set)
+	{
+		size_t before = this->count;
+		size_t slot = this->emplace_slot(pack(p));
+		if (this->count != before) {
+			this->values[slot] = v;
+		}
+		return this->count != before;
+	}
+
+	/* Value at p, value_t{} inserted first if p is new */
+	value_t& operator[](const P& p)
+		requires(!is_set)
+	{
+		return this->values[this->emplace_slot(pack(p))];
+	}
+
+	/* Pointer to the value at p, nullptr if p is not in the map */
+	const value_t* find(const P& p) const
+		requires(!is_set)
+	{
+		size_t slot = this->find_slot(pack(p));
+		return slot == npos ? nullptr : &this->values[slot];
+	}
+
+	value_t* find(const P& p)
+		requires(!is_set)
+	{
+		size_t slot = this->find_slot(pack(p));
+		return slot == npos ? nullptr : &this->values[slot];
+	}
+
+	/* Remove p, returns true if it was there */
+	bool erase(const P& p) {
+		size_t slot = this->find_slot(pack(p));
+		if (slot == npos) {
+			return false;
+		}
+
+		// shift the rest of the run back a slot, each one closer to home
+		size_t next = (slot + 1) & this->mask;
+		while (this->dist[next] > 1) {
+			this->keys[slot] = this->keys[next];
+			if constexpr (!is_set) {
+				this->values[slot] = std::move(this->values[next]);
+			}
+			this->dist[slot] = static_cast<uint8_t>(this->dist[next] - 1);
+			slot = next;
+			next = (next + 1) & this->mask;
+		}
+		this->dist[slot] = 0;
+		this->count--;
+		return true;
+	}
+
+	/* f(p) for a set, f(p, value) for a map, for every entry */
+	template <typename F>
+	void for_each(F&& f) const {
+		for (size_t i = 0; i < this->dist.size(); i++) {
+			if (this->dist[i]) {
+				if constexpr (is_set) {
+					f(unpack(this->keys[i]));
+				} else {
+					f(unpack(this->keys[i]), this->values[i]);
+				}
+			}
+		}
+	}
+
+	struct probe_stats_t {
+		double average = 0;	 // slots looked at to find an entry, 1 is best
+		size_t longest = 0;
+		double load = 0;	 // entries / slots
+	};
+
+	probe_stats_t probe_stats() const {
+		probe_stats_t stats;
+		size_t total = 0;
+		for (const auto d : this->dist) {
+			total += d;
+			stats.longest = std::max(stats.longest, static_cast<size_t>(d));
+		}
+		if (this->count) {
+			stats.average = static_cast<double>(total) / static_cast<double>(this->count);
+			stats.load = static_cast<double>(this->count) / static_cast<double>(this->dist.size());
+		}
+		return stats;
+	}
+
+	/* Iterates the entries in slot order: P for a set, or
+	 * pair<P, const value_t&> for a map.
+	 */
+	class iterator {
+	   public:
+		using iterator_category = std::forward_iterator_tag;
+		using difference_type = std::ptrdiff_t;
+		using value_type = std::conditional_t<is_set, P, std::pair<P, const value_t&>>;
+
+		iterator() {
+		}
+
+		iterator(const point_map_t* map, size_t slot) : map(map), slot(slot) {
+			this->skip_empty();
+		}
+
+		value_type operator*() const {
+			if constexpr (is_set) {
+				return unpack(this->map->keys[this->slot]);
+			} else {
+				return {unpack(this->map->keys[this->slot]), this->map->values[this->slot]};
+			}
+		}
+
+		iterator& operator++() {
+			this->slot++;
+			this->skip_empty();
+			return *this;
+		}
+
+		iterator operator++(int) {
+			auto old = *this;
+			++*this;
+			return old;
+		}
+
+		bool operator==(const iterator& other) const {
+			return this->slot == other.slot;
+		}
+
+	   private:
+		const point_map_t* map = nullptr;
+		size_t slot = 0;
+
+		void skip_empty() {
+			while (this->slot < this->map->dist.size() && this->map->dist[this->slot] == 0) {
+				this->slot++;
+			}
+		}
+	};
+
+	iterator begin() const {
+		return iterator(this, 0);
+	}
+
+	iterator end() const {
+		return iterator(this, this->dist.size());
+	}
+
+   private:
+	static constexpr size_t npos = ~size_t{0};
+
+	std::vector<key_t> keys = {};
+	std::vector<value_t> values = {};	// empty for a set
+	std::vector<uint8_t> dist = {};		// distance from home + 1, 0 is empty
+	size_t mask = 0;
+	size_t count = 0;
+
+	static key_t pack(const P& p) {
+		if constexpr (packed) {
+			constexpr size_t bits = sizeof(typename P::value_type) * 8;
+			uint64_t key = 0;
+			for (size_t i = 0; i < P::dimensions; i++) {
+				using unsigned_t = std::make_unsigned_t<typename P::value_type>;
+				key |= static_cast<uint64_t>(static_cast<unsigned_t>(p[i])) << (i * bits);
+			}
+			return key;
+		} else {
+			return p;
+		}
+	}
+
+	static P unpack(const key_t& key) {
+		if constexpr (packed) {
+			constexpr size_t bits = sizeof(typename P::value_type) * 8;
+			P p;
+			for (size_t i = 0; i < P::dimensions; i++) {
+				using unsigned_t = std::make_unsigned_t<typename P::value_type>;
+				p[i] = static_cast<typename P::value_type>(static_cast<unsigned_t>(key >> (i * bits)));
+			}
+			return p;
+		} else {
+			return key;
+		}
+	}
+
+	static size_t hash(const key_t& key) {
+		if constexpr (packed) {
+			return hash_mix(key);
+		} else {
+			return std::hash<P>()(key);
+		}
+	}
+
+	size_t find_slot(const key_t& key) const {
+		if (this->count == 0) {
+			return npos;
+		}
+
+		size_t slot = hash(key) & this->mask;
+		for (uint8_t d = 1; this->dist[slot] >= d; d++) {
+			if (this->dist[slot] == d && this->keys[slot] == key) {
+				return slot;
+			}
+			slot = (slot + 1) & this->mask;
+		}
+		return npos;
+	}
+
+	/* Slot of key, inserted (with value_t{}) if it is new */
+	size_t emplace_slot(key_t key) {
+		if ((this->count + 1) * 2 > this->dist.size()) {
+			size_t found = this->find_slot(key);
+			if (found != npos) {
+				return found;
+			}
+			this->rehash(std::max<size_t>(16, this->dist.size() * 2));
+		}
+
+		// look for key up to the first entry nearer home than it would be
+		size_t slot = hash(key) & this->mask;
+		uint8_t d = 1;
+		for (; this->dist[slot] >= d; d++) {
+			if (this->dist[slot] == d && this->keys[slot] == key) {
+				return slot;
+			}
+			slot = (slot + 1) & this->mask;
+			if (d == UINT8_MAX - 1) {
+				// a run this long means a bad hash, spread it out
+				this->rehash(this->dist.size() * 2);
+				return this->emplace_slot(key);
+			}
+		}
+
+		// Robin Hood: key goes here, the entry it displaces is carried on,
+		// swapping with any entry nearer home, until an empty slot
+		const key_t original = key;
+		const size_t placed = slot;
+		value_t value{};
+		while (this->dist[slot] != 0) {
+			if (this->dist[slot] < d) {
+				std::swap(this->keys[slot], key);
+				if constexpr (!is_set) {
+					std::swap(this->values[slot], value);
+				}
+				std::swap(this->dist[slot], d);
+			}
+
+			slot = (slot + 1) & this->mask;
+			if (++d == UINT8_MAX) {
+				// as above, then put the entry still being carried back in
+				this->rehash(this->dist.size() * 2);
+				size_t carried = this->emplace_slot(key);
+				if constexpr (!is_set) {
+					this->values[carried] = std::move(value);
+				}
+				return this->find_slot(original);
+			}
+		}
+
+		this->keys[slot] = key;
+		if constexpr (!is_set) {
+			this->values[slot] = std::move(value);
+		}
+		this->dist[slot] = d;
+		this->count++;
+		return placed;
+	}
+
+	void rehash(size_t capacity) {
+		std::vector<key_t> old_keys = std::move(this->keys);
+		std::vector<value_t> old_values = std::move(this->values);
+		std::vector<uint8_t> old_dist = std::move(this->dist);
+
+		this->keys.assign(capacity, key_t{});
+		if constexpr (!is_set) {
+			this->values.assign(capacity, value_t{});
+		}
+		this->dist.assign(capacity, 0);
+		this->mask = capacity - 1;
+		this->count = 0;
+
+		for (size_t i = 0; i < old_dist.size(); i++) {
+			if (old_dist[i]) {
+				size_t slot = this->emplace_slot(old_keys[i]);
+				if constexpr (!is_set) {
+					this->values[slot] = std::move(old_values[i]);
+				}
+			}
+		}
+	}
+};
+
+template <typename P = point_t>
+using point_set_t = point_map_t<P, void>;
+
+#endif
@@ -5,19 +5,23 @@
 #include <chrono>	  // high resolution timer
 #include <cstring>	  // strtok, strdup
 #include <fstream>	  // ifstream (reading file)
+#include <future>	  // async (parallel parts)
 #include <numeric>	  // max, reduce, etc.
+#include <random>	  // generated inputs
 #include <print>
 #include <ranges>  // ranges and views
 #include <string>  // strings
 #include <vector>  // collectin
-#include <unordered_set>
 
+#include "differential.h"
+#include "morton.h"
 #include "point.h"
+#include "point_map.h"
 
 using namespace std;
 
 /* Update with data type and result types */
-using data_t = unordered_set<point_t>;
+using data_t = point_set_t<point_t>;
 using result_t = size_t;
 
 /* for pretty printing durations */
@@ -86,7 +90,7 @@ void print_state(const data_t& state) {
 
 /* Return set of sites that neighbor site(p) in 3D space */
 data_t get_neighbors_3d(const point_t& p) {
-	data_t neighbors;
+	data_t neighbors(26);
 
 	for (long z = -1; z <= 1; z++) {
 		for (long y = -1; y <= 1; y++) {
@@ -104,7 +108,7 @@ data_t get_neighbors_3d(const point_t& p) {
 
 /* Return set of sites that neighbor site(p) in 4D space */
 data_t get_neighbors_4d(const point_t& p) {
-	data_t neighbors;
+	data_t neighbors(80);
 
 	for (long w = -1; w <= 1; w++) {
 		for (long z = -1; z <= 1; z++) {
@@ -122,26 +126,26 @@ data_t get_neighbors_4d(const point_t& p) {
 	return neighbors;
 }
 
-/* Global function pointer, default is 3D for part 1
- * change to 4D for part 2.
+/* Neighbor function, 3D for part 1 and 4D for part 2.
+ * Passed down rather than global so both parts can run at the same time.
  */
-data_t (*get_neighbors)(const point_t& p) = get_neighbors_3d;
-
+using neighbors_fn_t = data_t (*)(const point_t& p);
 
 /* Return the set of all neighbors for all the sites in the passed set. */
-data_t get_all_neighbors(const data_t& sites) {
+data_t get_all_neighbors(const data_t& sites, neighbors_fn_t get_neighbors) {
 	data_t all_neighbors;
 
 	for (const auto& p : sites) {
-		auto neighbors = get_neighbors(p);
-		all_neighbors.insert(neighbors.begin(), neighbors.end());
+		for (const auto& neighbor : get_neighbors(p)) {
+			all_neighbors.insert(neighbor);
+		}
 	}
 
 	return all_neighbors;
 }
 
 /* Return the number of active neighboring sites for site(p)*/
-size_t count_neighbors(const data_t& state, const point_t& p) {
+size_t count_neighbors(const data_t& state, const point_t& p, neighbors_fn_t get_neighbors) {
 	size_t neighbor_count = 0;
 	for (const auto& neighbor : get_neighbors(p)) {
 		if (state.contains(neighbor)) {
@@ -153,8 +157,8 @@ size_t count_neighbors(const data_t& state, const point_t& p) {
 }
 
 /* Return the next state for the given site(p) */
-bool next_state(const data_t& state, const point_t& p) {
-	size_t neighbors = count_neighbors(state, p);
+bool next_state(const data_t& state, const point_t& p, neighbors_fn_t get_neighbors) {
+	size_t neighbors = count_neighbors(state, p, get_neighbors);
 	if (state.contains(p)) {	// active
 		return neighbors == 2 || neighbors == 3;
 	} else {
@@ -165,12 +169,12 @@ bool next_state(const data_t& state, const point_t& p) {
 }
 
 /* Return the next state for the entirety of the current state */
-data_t next_state(const data_t& current) {
+data_t next_state(const data_t& current, neighbors_fn_t get_neighbors) {
 	data_t next;
 
-	data_t active_neighbors = get_all_neighbors(current);
+	data_t active_neighbors = get_all_neighbors(current, get_neighbors);
 	for (const auto& neighbor : active_neighbors) {
-		if (next_state(current, neighbor)) {
+		if (next_state(current, neighbor, get_neighbors)) {
 			next.insert(neighbor);
 		}
 	}
@@ -179,11 +183,11 @@ data_t next_state(const data_t& current) {
 }
 
 /* Return the state after the number of generations */
-data_t next_state(const data_t& start, size_t generations) {
+data_t next_state(const data_t& start, size_t generations, neighbors_fn_t get_neighbors) {
 	data_t current = start;
 	// print_state(current);
 	while (generations--) {
-		data_t next = next_state(current);
+		data_t next = next_state(current, get_neighbors);
 		current = next;
 		// print_state(current);
 	}
@@ -191,30 +195,88 @@ data_t next_state(const data_t& start, size_t generations) {
 	return current;
 }
 
+/* Return the offsets to all neighbors in 3D or 4D space */
+vector<point_t> neighbor_offsets(const point_t& p, neighbors_fn_t get_neighbors) {
+	vector<point_t> offsets;
+	for (const auto& neighbor : get_neighbors(p)) {
+		offsets.push_back(neighbor - p);
+	}
+
+	return offsets;
+}
+
+/* Return the number of active sites after the number of generations.
+ * Same as next_state() but on Morton ordered keys, neighbors are near each
+ * other in memory rather than scattered across hash buckets.
+ */
+size_t morton_state(const data_t& start, size_t generations, neighbors_fn_t get_neighbors) {
+	auto offsets = neighbor_offsets({0, 0}, get_neighbors);
+
+	morton_set_t current = morton_set_t::from_points(start);
+	while (generations--) {
+		current = current.next_generation(offsets, [](bool active, size_t neighbors) {
+			return neighbors == 3 || (active && neighbors == 2);
+		});
+	}
+
+	return current.size();
+}
+
 /* Part 1 */
 result_t part1(const data_t& data) {
 	/* Return the number of active sites after 6 generations */
-	data_t final = next_state(data, 6);
-	return final.size();
+	return morton_state(data, 6, get_neighbors_3d);
 }
 
 /* Part 2*/
 result_t part2([[maybe_unused]] const data_t& data) {
 	/* Return the number of active sites after 6 generations in 4D space */
-	get_neighbors = get_neighbors_4d;
-	data_t final = next_state(data, 6);
-	return final.size();
+	return morton_state(data, 6, get_neighbors_4d);
+}
+
+/* Return a random size x size starting slice, about a third active */
+data_t generate_data(size_t size, unsigned seed) {
+	mt19937 rng(seed);
+	data_t data;
+
+	for (size_t y = 0; y < size; y++) {
+		for (size_t x = 0; x < size; x++) {
+			if (rng() % 3 == 0) {
+				data.insert({static_cast<long>(x), static_cast<long>(y), 0l, 0l});
+			}
+		}
+	}
+
+	return data;
 }
 
+/* The hash set next_state() is the reference for the Morton versions */
+const vector<differential_t<data_t, result_t>> differentials = {
+	{"part1", [](const data_t& data) { return next_state(data, 6, get_neighbors_3d).size(); }, part1},
+	{"part2", [](const data_t& data) { return next_state(data, 6, get_neighbors_4d).size(); }, part2},
+};
+
 int main(int argc, char* argv[]) {
 	bool verbose = false;
+	bool parallel = false;
+	bool differential = false;
+	size_t generate_size = 0;
 
 	int c;
-	while ((c = getopt(argc, argv, "v")) != -1) {
+	while ((c = getopt(argc, argv, "vpdg:")) != -1) {
 		switch (c) {
 			case 'v':
 				verbose = !verbose;
 				break;
+			case 'p':
+				parallel = !parallel;
+				break;
+			case 'd':
+				differential = !differential;
+				break;
+			case 'g':
+				generate_size = stoul(optarg);
+				break;
 			default:
 				std::print(stderr, "ERROR: Unknown option \"{}\"\n", c);
 				exit(1);
@@ -224,6 +286,12 @@ int main(int argc, char* argv[]) {
 	argc -= optind;
 	argv += optind;
 
+	// check optimized against reference on generated inputs, no input file
+	if (generate_size) {
+		bool ok = run_differentials<data_t, result_t>(differentials, generate_data, generate_size);
+		exit(ok ? 0 : 3);
+	}
+
 	const char* input_file = argv[0];
 	if (argc != 1) {
 		std::print(stderr, "ERROR: No input file specified\n");
@@ -240,18 +308,44 @@ int main(int argc, char* argv[]) {
 		print("{:>15} ({:>10.4f}ms)\n", "parse", parse_time.count());
 	}
 
-	result_t p1_result = part1(data);
+	// check optimized against reference on the input file
+	if (differential) {
+		exit(run_differentials(differentials, data) ? 0 : 3);
+	}
 
-	auto p1_complete = chrono::high_resolution_clock::now();
-	duration_t p1_time = p1_complete - parse_complete;
-	print("{:>15} ({:>10.4f}ms){}", p1_result, p1_time.count(), verbose ? "\n" : "");
+	/* Run one part on the data, returning its result and how long it took. */
+	auto run_part = [&data](auto part) -> pair<result_t, duration_t> {
+		auto part_start = chrono::high_resolution_clock::now();
+		result_t result = part(data);
+		duration_t part_time = chrono::high_resolution_clock::now() - part_start;
+		return {result, part_time};
+	};
+
+	pair<result_t, duration_t> p1, p2;
+	if (parallel) {
+		// both parts only read data, so each can run on its own thread
+		auto p1_future = async(launch::async, run_part, part1);
+		auto p2_future = async(launch::async, run_part, part2);
+		p1 = p1_future.get();
+		p2 = p2_future.get();
+	} else {
+		p1 = run_part(part1);
+		p2 = run_part(part2);
+	}
 
-	result_t p2_result = part2(data);
+	auto parts_complete = chrono::high_resolution_clock::now();
 
-	auto p2_complete = chrono::high_resolution_clock::now();
-	duration_t p2_time = p2_complete - p1_complete;
+	auto [p1_result, p1_time] = p1;
+	print("{:>15} ({:>10.4f}ms){}", p1_result, p1_time.count(), verbose ? "\n" : "");
+
+	auto [p2_result, p2_time] = p2;
 	print("{:>15} ({:>10.4f}ms){}", p2_result, p2_time.count(), verbose ? "\n" : "");
 
-	duration_t total_time = p2_complete - start_time;
+	if (verbose) {
+		duration_t wall_time = parts_complete - parse_complete;
+		print("{:>15} ({:>10.4f}ms)\n", parallel ? "parallel" : "sequential", wall_time.count());
+	}
+
+	duration_t total_time = parts_complete - start_time;
 	print("{:>15} ({:>10.4f}ms)\n", "total", total_time.count());
 }
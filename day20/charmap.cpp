@@ -0,0 +1,105 @@
+#include "charmap.h"
+
+#include <fcntl.h>	 // open
+#include <string.h>
+#include <sys/mman.h>  // mmap
+#include <sys/stat.h>  // fstat
+#include <unistd.h>	   // close
+
+#include <algorithm>
+#include <iomanip>	 // setw and setprecision on output
+#include <iostream>	 // cout
+#include <sstream>	 // std::ostringstream
+
+charmap_t charmap_t::map_file(const std::string& file_name) {
+	int fd = open(file_name.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return charmap_t::from_file(file_name);
+	}
+
+	struct stat st;
+	void* ptr = MAP_FAILED;
+	size_t length = 0;
+	if (fstat(fd, &st) == 0 && st.st_size > 0) {
+		length = static_cast<size_t>(st.st_size);
+		ptr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+	}
+	close(fd);
+	if (ptr == MAP_FAILED) {
+		return charmap_t::from_file(file_name);
+	}
+
+	std::shared_ptr<const void> mapping(ptr, [length](const void* p) { munmap(const_cast<void*>(p), length); });
+	std::string_view text(static_cast<const char*>(ptr), length);
+
+	// every line must be as long as the first and end in '\n' (bar the last)
+	size_t width = std::min(text.find('\n'), length);
+	size_t stride = width + 1;
+	size_t rows = (length + 1) / stride;
+	size_t newlines = length / stride;
+	bool rectangle = width > 0 && text[width - 1] != '\r' && (length + 1) % stride <= 1
+		&& static_cast<size_t>(std::count(text.begin(), text.end(), '\n')) == newlines;
+	for (size_t y = 1; rectangle && y <= newlines; y++) {
+		rectangle = text[y * stride - 1] == '\n';
+	}
+	if (!rectangle) {
+		return charmap_t::from_file(file_name);
+	}
+
+	charmap_t map;
+	map.size_x = static_cast<dimension_t>(width);
+	map.size_y = static_cast<dimension_t>(rows);
+	map.stride = static_cast<dimension_t>(stride);
+	map.mapped = text;
+	map.mapping = std::move(mapping);
+	return map;
+}
+
+// static const char *highlight_chars = "^>v<";
+static const char* highlight_chars = "";
+
+std::ostream& operator<<(std::ostream& os, const charmap_t& map) {
+	std::ostringstream buffer;
+
+	os << "   ";
+	for (auto x = 0; x < map.size_x; ++x) {
+		os << x % 10;
+	}
+	os << "\n";
+
+	os << "-+-";
+	for (auto x = 0; x < map.size_x; ++x) {
+		os << "-";
+	}
+	os << "-+-\n";
+
+	// size_t ymin = map.show_context < 5 ? 0 : map.show_context-5;
+	// size_t ymax = std::min(map.size_y, map.show_context+5);
+	dimension_t ymin = 0;
+	dimension_t ymax = map.size_y;
+	for (auto y = ymin; y < ymax; y++) {
+		os << y % 10 << "| ";
+
+		auto row = map.row(y);
+		for (auto xit = row.begin(); xit != row.end(); ++xit) {
+			if (strchr(highlight_chars, *xit) == NULL) {
+				os << *xit;
+			} else {
+				os << "\033[7m" << *xit << "\033[m";
+			}
+		}
+		os << " |" << y << "\n";
+	}
+
+	os << "-+-";
+	for (auto x = 0; x < map.size_x; ++x) {
+		os << "-";
+	}
+	os << "-+-\n   ";
+	for (auto x = 0; x < map.size_x; ++x) {
+		os << x % 10;
+	}
+	os << "\n";
+
+	return os;
+}
@@ -0,0 +1,206 @@
+#if !defined(GRID_VIEW_T_H)
+#define GRID_VIEW_T_H
+
+#include <cstddef>	// size_t
+#include <string>	// std::string
+#include <type_traits>	// is_const_v
+#include <utility>	// swap
+
+#include "charmap.h"
+#include "point.h"
+
+/* A window onto a grid of chars someone else owns (a charmap_t, a string,
+ * ...) seen in any of the 8 orientations of the square: the rotations and
+ * their mirror images.
+ *
+ * The view keeps the base rectangle it covers (origin and extent) and three
+ * bits: swap x and y, then mirror x and/or y within the rectangle. Every
+ * orientation is one of those 8 combinations, so rotate(), flip_rows(),
+ * sub() and orientation() just return a new view; nothing is copied, the
+ * transform is done on each index.
+ *
+ * C is const char for a read-only view, char to write through it.
+ *
+ *	grid_view_t<const char> tile(data.data(), 10, 10, 10);
+ *	auto inner = tile.sub(1, 1, 8, 8);	// drop the border
+ *	for (unsigned i = 0; i < grid_view_t<>::orientations; i++) {
+ *		auto turned = inner.orientation(i);
+ *		...
+ *	}
+ */
+template <typename C = const char>
+struct grid_view_t {
+	static constexpr unsigned orientations = 8;
+
+	C* cells = nullptr;		 // cell 0, 0 of the base grid
+	dimension_t stride = 0;	 // chars from one base row to the next
+	dimension_t origin_x = 0;  // base rectangle the view covers
+	dimension_t origin_y = 0;
+	dimension_t size_x = 0;	 // size as seen through the view
+	dimension_t size_y = 0;
+	bool swap_xy = false;
+	bool flip_x = false;  // mirrored in base x, after any swap
+	bool flip_y = false;
+
+	grid_view_t() {
+	}
+
+	grid_view_t(C* cells, dimension_t stride, dimension_t size_x, dimension_t size_y)
+		: cells(cells), stride(stride), size_x(size_x), size_y(size_y) {
+	}
+
+	// the whole of map (not the halo)
+	explicit grid_view_t(const charmap_t& map)
+		requires std::is_const_v<C>
+		: grid_view_t(map.size_y ? map.row(0).data() : nullptr, map.stride, map.size_x, map.size_y) {
+	}
+
+	explicit grid_view_t(charmap_t& map)
+		: grid_view_t(map.size_y ? map.row(0).data() : nullptr, map.stride, map.size_x, map.size_y) {
+	}
+
+	template <std::convertible_to<dimension_t> Tx, std::convertible_to<dimension_t> Ty>
+	bool is_valid(const Tx x, const Ty y) const {
+		dimension_t native_x = static_cast<dimension_t>(x);
+		dimension_t native_y = static_cast<dimension_t>(y);
+		return 0 <= native_x && native_x < this->size_x && 0 <= native_y && native_y < this->size_y;
+	}
+
+	bool is_valid(const point_t& p) const {
+		return is_valid(p.x, p.y);
+	}
+
+	/* Offset in cells of view x, y, which must be valid */
+	size_t offset(const dimension_t x, const dimension_t y) const {
+		dimension_t u = this->swap_xy ? y : x;
+		dimension_t v = this->swap_xy ? x : y;
+		dimension_t base_x = this->origin_x + (this->flip_x ? this->extent_x() - 1 - u : u);
+		dimension_t base_y = this->origin_y + (this->flip_y ? this->extent_y() - 1 - v : v);
+		return static_cast<size_t>(base_y * this->stride + base_x);
+	}
+
+	// unchecked
+	C& operator()(const dimension_t x, const dimension_t y) const {
+		return this->cells[this->offset(x, y)];
+	}
+
+	template <std::convertible_to<dimension_t> Tx, std::convertible_to<dimension_t> Ty>
+	char get(const Tx x, const Ty y, const char invalid = '\0') const {
+		return this->is_valid(x, y) ? (*this)(static_cast<dimension_t>(x), static_cast<dimension_t>(y)) : invalid;
+	}
+
+	char get(const point_t& p, const char invalid = '\0') const {
+		return this->get(p.x, p.y, invalid);
+	}
+
+	bool is_char(const point_t& p, const char c) const {
+		return this->get(p) == c;
+	}
+
+	/* The w x h window at x, y of this view, in the same orientation */
+	grid_view_t sub(dimension_t x, dimension_t y, dimension_t w, dimension_t h) const {
+		grid_view_t view = *this;
+		dimension_t u = this->swap_xy ? y : x;
+		dimension_t v = this->swap_xy ? x : y;
+		dimension_t extent_u = this->swap_xy ? h : w;
+		dimension_t extent_v = this->swap_xy ? w : h;
+		view.origin_x += this->flip_x ? this->extent_x() - u - extent_u : u;
+		view.origin_y += this->flip_y ? this->extent_y() - v - extent_v : v;
+		view.size_x = w;
+		view.size_y = h;
+		return view;
+	}
+
+	/* Swap x and y (mirror in the leading diagonal) */
+	grid_view_t transpose() const {
+		grid_view_t view = *this;
+		view.swap_xy = !view.swap_xy;
+		std::swap(view.size_x, view.size_y);
+		return view;
+	}
+
+	/* Rows in reverse order (mirror top to bottom) */
+	grid_view_t flip_rows() const {
+		grid_view_t view = *this;
+		(this->swap_xy ? view.flip_x : view.flip_y) ^= true;
+		return view;
+	}
+
+	/* Columns in reverse order (mirror left to right) */
+	grid_view_t flip_columns() const {
+		grid_view_t view = *this;
+		(this->swap_xy ? view.flip_y : view.flip_x) ^= true;
+		return view;
+	}
+
+	/* Turned 90 degrees, so new (x, y) is old (size_x - 1 - y, x) */
+	grid_view_t rotate() const {
+		return this->transpose().flip_rows();
+	}
+
+	/* Each of i = 0..7 is a different orientation, 0 is this one */
+	grid_view_t orientation(unsigned i) const {
+		grid_view_t view = (i & 4) ? this->transpose() : *this;
+		view.flip_x ^= (i & 1) != 0;
+		view.flip_y ^= (i & 2) != 0;
+		return view;
+	}
+
+	std::string row_string(const dimension_t y) const {
+		std::string str;
+		str.reserve(static_cast<size_t>(this->size_x));
+		for (dimension_t x = 0; x < this->size_x; x++) {
+			str += (*this)(x, y);
+		}
+		return str;
+	}
+
+	std::string column_string(const dimension_t x) const {
+		std::string str;
+		str.reserve(static_cast<size_t>(this->size_y));
+		for (dimension_t y = 0; y < this->size_y; y++) {
+			str += (*this)(x, y);
+		}
+		return str;
+	}
+
+	/* f(x, y, cell&) for every cell of the view */
+	template <typename F>
+	void for_each_cell(F&& f) const {
+		for (dimension_t y = 0; y < this->size_y; y++) {
+			for (dimension_t x = 0; x < this->size_x; x++) {
+				f(x, y, (*this)(x, y));
+			}
+		}
+	}
+
+	size_t count(const char ch) const {
+		size_t total = 0;
+		this->for_each_cell([&total, ch](dimension_t, dimension_t, char cell) {
+			total += (cell == ch) ? 1 : 0;
+		});
+		return total;
+	}
+
+	/* Rows separated by '\n' */
+	std::string to_string() const {
+		std::string str;
+		str.reserve(static_cast<size_t>((this->size_x + 1) * this->size_y));
+		for (dimension_t y = 0; y < this->size_y; y++) {
+			str += this->row_string(y) + "\n";
+		}
+		return str;
+	}
+
+   private:
+	// size of the base rectangle
+	dimension_t extent_x() const {
+		return this->swap_xy ? this->size_y : this->size_x;
+	}
+
+	dimension_t extent_y() const {
+		return this->swap_xy ? this->size_x : this->size_y;
+	}
+};
+
+#endif
@@ -12,16 +12,17 @@
 #include <string>  // strings
 #include <vector>  // collection
 
+#include "grid_view.h"	// rotated and flipped tiles
+#include "simd.h"	// count_char
 #include "split.h"	// split strings
 
 using namespace std;
 
+/* A tile as read, size x size chars with the newlines taken out */
 struct tile_t {
 	size_t id = 0;
-	vector<string> data = {};
-
-	string _left = "";
-	string _right = "";
+	dimension_t size = 0;
+	string cells = "";
 
 	tile_t(const string& raw) {
 		const auto parts = split(raw, "\n");
@@ -30,128 +31,58 @@ struct tile_t {
 		const size_t id_end = parts[0].find(':');
 		id = stoul(parts[0].substr(id_start, id_end-id_start));
 
-		data.insert(data.begin(), parts.begin()+1, parts.end());
-
-		update_edges();
-	}
-
-	tile_t(size_t id, const vector<string>& data) : id(id), data(data) {
-		update_edges();
-	}
-
-	void update_edges() {
-		for (const auto& row : data) {
-			_left += row[0];
+		size = static_cast<dimension_t>(parts[1].size());
+		for (auto it = parts.begin() + 1; it != parts.end(); ++it) {
+			cells += *it;
 		}
-
-		for (const auto& row : data) {
-			_right += row[size()-1];
-		}
-	}
-
-	const string map_data(const size_t row) {
-		return data[row].substr(1, size()-2);
-	}
-
-	size_t size() const {
-		return data[0].size();
 	}
 
-	const string top() const {
-		return data[0];
+	tile_t(size_t id, dimension_t size, string cells) : id(id), size(size), cells(std::move(cells)) {
 	}
 
-	const string bottom() const {
-		return data[size()-1];
-	}
-
-	const string left() const {
-		return _left;
-	}
-
-	const string right() const {
-		return _right;
-	}
-
-	/* is data at x,y == ch */
-	bool is_char(const size_t x, const size_t y, const char ch) const {
-		return y < data.size() && x < data[y].size() && data[y][x] == ch;
-	}
-
-	/* set tile data at x, y to ch*/
-	void set_char(const size_t x, const size_t y, const char ch) {
-		if (y < data.size() && x < data[y].size()) {
-			data[y][x] = ch;
-		}
+	grid_view_t<const char> view() const {
+		return {cells.data(), size, size, size};
 	}
 
 	/* return the number of `needle` in the tile data */
 	size_t count_char(const char needle) const {
-		size_t char_count = 0;
-
-		for (const auto & row : data) {
-			for (const auto ch : row) {
-				if (ch == needle) {
-					char_count++;
-				}
-			}
-		}
-
-		return char_count;
+		return ::count_char(cells, needle);
 	}
+};
 
-	void print() const {
-		std::print("{}:\n", this->id);
-		for (const auto &l : this->data) {
-			std::print("{}\n", l);
-		}
-	}
+/* One orientation of a tile: a view of its cells, and its edges for matching.
+ * The view points into the tile_t, which has to outlive it.
+ */
+struct oriented_tile_t {
+	size_t id = 0;
+	grid_view_t<const char> view = {};
 
-	const string to_string() const {
-		string str;
-		str.reserve(data.size() * data.size());
+	string top = "";
+	string bottom = "";
+	string left = "";
+	string right = "";
 
-		for (const auto &row_str : data) {
-			str += row_str + "\n";
-		}
-		
-		return str;
+	oriented_tile_t(size_t id, const grid_view_t<const char>& view)
+		: id(id),
+		  view(view),
+		  top(view.row_string(0)),
+		  bottom(view.row_string(view.size_y - 1)),
+		  left(view.column_string(0)),
+		  right(view.column_string(view.size_x - 1)) {
 	}
 
-};
-
-/* Return a new tile (with the same id) rotated 90 degrees. */
-tile_t rotate(const tile_t& tile) {
-	size_t dim = tile.data.size();
-	vector<string> rotated(dim);
-
-	for (size_t y = 0; y < dim; y++) {
-		for (size_t x = 0; x < dim; x++) {
-			rotated[(dim-1)-x] += tile.data[y][x];
-		}
+	void print() const {
+		std::print("{}:\n{}", this->id, this->view.to_string());
 	}
+};
 
-	return {tile.id, rotated};
-}
-
-/* Return a new tile (with the same id) with rows reversed (flipped) */
-tile_t flip(const tile_t& tile) {
-	vector<string> flipped(tile.data.rbegin(), tile.data.rend());
-
-	return {tile.id, flipped};
-}
-
-/* Return a vector containing all possible variations(transformations)
- * of the original tile. All rotations and flips.
+/* Return all the orientations (rotations and flips) of the tile.
+ * They are views, so this does not copy the tile.
  */
-vector<tile_t> tile_transforms(const tile_t& tile) {
-	tile_t work = tile;
-	vector<tile_t> tiles = {work, flip(work)};
-
-	for (size_t i =0; i < 3; i++) {
-		work = rotate(work);
-		tiles.push_back(work);
-		tiles.push_back(flip(work));
+vector<oriented_tile_t> tile_transforms(const tile_t& tile) {
+	vector<oriented_tile_t> tiles;
+	for (unsigned i = 0; i < grid_view_t<>::orientations; i++) {
+		tiles.emplace_back(tile.id, tile.view().orientation(i));
 	}
 
 	return tiles;
@@ -193,12 +124,12 @@ const data_t read_data(const string& filename) {
 /* Find tile index of tile that fits above of tile with index `idx` in `all` 
  * tiles or size of the `all` tile vector to signal not-found.
  */
-size_t find_above(const size_t id, const vector<tile_t>& all) {
-	const tile_t &tile = all[id];
+size_t find_above(const size_t id, const vector<oriented_tile_t>& all) {
+	const oriented_tile_t &tile = all[id];
 
 	for (size_t i = 0; i < all.size(); i++) {
-		const tile_t& other = all[i];
-		if (tile.id != other.id && tile.top() == other.bottom()) {
+		const oriented_tile_t& other = all[i];
+		if (tile.id != other.id && tile.top == other.bottom) {
 			return i;
 		}
 	}
@@ -209,12 +140,12 @@ size_t find_above(const size_t id, const vector<tile_t>& all) {
 /* Find tile index of tile that fits left of tile with index `idx` in `all`
  * tiles or size of the `all` tile vector to signal not-found.
  */
-size_t find_left(const size_t id, const vector<tile_t>& all) {
-	const tile_t &tile = all[id];
+size_t find_left(const size_t id, const vector<oriented_tile_t>& all) {
+	const oriented_tile_t &tile = all[id];
 
 	for (size_t i = 0; i < all.size(); i++) {
-		const tile_t& other = all[i];
-		if (tile.id != other.id && tile.left() == other.right()) {
+		const oriented_tile_t& other = all[i];
+		if (tile.id != other.id && tile.left == other.right) {
 			return i;
 		}
 	}
@@ -225,12 +156,12 @@ size_t find_left(const size_t id, const vector<tile_t>& all) {
 /* Find tile index of tile that fits right of tile with index `idx` in `all`
  * tiles or size of the `all` tile vector to signal not-found.
  */
-size_t find_right(const size_t idx, const vector<tile_t>& all) {
-	const tile_t &tile = all[idx];
+size_t find_right(const size_t idx, const vector<oriented_tile_t>& all) {
+	const oriented_tile_t &tile = all[idx];
 
 	for (size_t i = 0; i < all.size(); i++) {
-		const tile_t& other = all[i];
-		if (tile.id != other.id && tile.right() == other.left()) {
+		const oriented_tile_t& other = all[i];
+		if (tile.id != other.id && tile.right == other.left) {
 			return i;
 		}
 	}
@@ -241,12 +172,12 @@ size_t find_right(const size_t idx, const vector<tile_t>& all) {
 /* Find tile index of tile that fits below tile with index `idx` in `all`
  * tiles or size of the `all` tile vector to signal not-found.
  */
-size_t find_below(const size_t idx, const vector<tile_t>& all) {
-	const tile_t &tile = all[idx];
+size_t find_below(const size_t idx, const vector<oriented_tile_t>& all) {
+	const oriented_tile_t &tile = all[idx];
 
 	for (size_t i = 0; i < all.size(); i++) {
-		const tile_t& other = all[i];
-		if (tile.id != other.id && tile.bottom() == other.top()) {
+		const oriented_tile_t& other = all[i];
+		if (tile.id != other.id && tile.bottom == other.top) {
 			return i;
 		}
 	}
@@ -254,7 +185,7 @@ size_t find_below(const size_t idx, const vector<tile_t>& all) {
 	return all.size();
 }
 
-size_t find_corner(const vector<tile_t>& all) {
+size_t find_corner(const vector<oriented_tile_t>& all) {
 	for (size_t idx = 0; idx < all.size(); idx++) {
 		if (find_above(idx, all) == all.size() && find_left(idx, all) == all.size()) {
 			return idx;
@@ -265,10 +196,10 @@ size_t find_corner(const vector<tile_t>& all) {
 }
 
 /* Return a 2D vector of tiles arranged based on matching edges. */
-vector<vector<tile_t>> arrange_tiles(const vector<tile_t> &tiles) {
+vector<vector<oriented_tile_t>> arrange_tiles(const vector<tile_t> &tiles) {
 
 	// All tile orientations (rotations and flips) for all tiles
-	vector<tile_t> all;
+	vector<oriented_tile_t> all;
 	for (const auto& tile : tiles) {
 		const auto tf = tile_transforms(tile);
 		all.insert(all.end(), tf.begin(), tf.end());
@@ -281,18 +212,18 @@ vector<vector<tile_t>> arrange_tiles(const vector<tile_t> &tiles) {
 	//	insert and iterate until we don't find a right tile.
 	// Look for the tile that goes below the leftmost tile
 	//	make it the new leftmost and repeat until we don't find any below tiles
-	vector<vector<tile_t>> arranged;
+	vector<vector<oriented_tile_t>> arranged;
 
 	size_t left_idx = find_corner(all);
 	while (left_idx < all.size()) {
-		vector<tile_t> row;
+		vector<oriented_tile_t> row;
 
-		tile_t& left_tile = all[left_idx];
+		oriented_tile_t& left_tile = all[left_idx];
 		row.push_back(left_tile);
 		
 		size_t right_idx = find_right(left_idx, all);
 		while (right_idx < all.size()) {
-			tile_t& right_tile = all[right_idx];
+			oriented_tile_t& right_tile = all[right_idx];
 			row.push_back(right_tile);	
 
 			right_idx = find_right(right_idx, all);
@@ -319,26 +250,27 @@ result_t part1(const data_t& tiles) {
 	return result;
 }
 
-/* Return a tile representing the final arranged tile map, removing tile edges */
-const tile_t merge_tiles(const size_t id, const vector<vector<tile_t>> &tiles) {
-	vector<string> data;
-	const size_t tile_size = tiles[0][0].data.size();
+/* Return a tile representing the final arranged tile map, removing tile edges.
+ * This is the one copy: the inside of each (oriented) tile into the image.
+ */
+const tile_t merge_tiles(const size_t id, const vector<vector<oriented_tile_t>> &tiles) {
+	const dimension_t inner = tiles[0][0].view.size_x - 2;
+	const dimension_t size = inner * static_cast<dimension_t>(tiles.size());
+	string cells;
+	cells.reserve(static_cast<size_t>(size * size));
 
 	// for each tile row
 	for (const auto& tile_row : tiles) {
 		// for each row in the output
-		for (size_t r = 1; r < tile_size - 1; r++) {
-			string row_data;
-			// for each tile in the row
+		for (dimension_t r = 0; r < inner; r++) {
+			// for each tile in the row, its row without the edges
 			for (const auto& tile : tile_row) {
-				row_data += tile.data[r].substr(1, tile_size - 2);
+				cells += tile.view.sub(1, 1, inner, inner).row_string(r);
 			}
-
-			data.push_back(row_data);
 		}
 	}
 
-	return {id, data};
+	return {id, size, cells};
 }
 
 /* Vector representation of the sea monster we are looking for
@@ -355,12 +287,16 @@ const vector<vector<size_t>> monster = {
 };
 const size_t monster_height = 3;
 const size_t monster_width = 19;
+const size_t monster_cells = 15;
 
-/* Return true if we are able to erase a sea monster at (x, y) */
-bool erase_monster(tile_t& tile, size_t x, size_t y) {
+/* Return true if there is a sea monster at (x, y) made of '#' not already
+ * part of another; if so mark its cells as erased.
+ */
+bool erase_monster(const grid_view_t<const char>& image, vector<bool>& erased, size_t x, size_t y) {
+	const size_t size = static_cast<size_t>(image.size_x);
 	for (size_t dy = 0; dy < monster.size(); dy++) {
 		for (const auto dx : monster[dy]) {
-			if (!tile.is_char(x+dx, y+dy, '#')) {
+			if (!image.is_char({x+dx, y+dy}, '#') || erased[(y+dy) * size + x+dx]) {
 				return false;
 			}
 		}
@@ -368,30 +304,33 @@ bool erase_monster(tile_t& tile, size_t x, size_t y) {
 
 	for (size_t dy = 0; dy < monster.size(); dy++) {
 		for (const auto dx : monster[dy]) {
-			tile.set_char(x+dx, y+dy, 'O');
+			erased[(y+dy) * size + x+dx] = true;
 		}
 	}
 
 	return true;
 }
 
-/* Erase all sea monsters from tile and return number erased. */
-size_t erase_monsters(tile_t& tile) {
-	size_t size = tile.data.size();
-	size_t erased = 0;
+/* Erase all sea monsters from the image and return the number of cells
+ * erased; the image itself is only read.
+ */
+size_t erase_monsters(const grid_view_t<const char>& image) {
+	size_t size = static_cast<size_t>(image.size_x);
+	vector<bool> erased(size * size);
+	size_t erased_cells = 0;
 
 	/* No need to search where we won't find monsters
 	 * e.g. beyond the bounds of how big they are.
 	 */
 	for (size_t y = 0; y < size - monster_height; y++) {
 		for (size_t x = 0; x < size - monster_width; x++) {
-			if (erase_monster(tile, x, y)) {
-				erased++;
+			if (erase_monster(image, erased, x, y)) {
+				erased_cells += monster_cells;
 			}
 		}
 	}
 
-	return erased;
+	return erased_cells;
 }
 
 /* Part 2 */
@@ -401,13 +340,14 @@ result_t part2(const data_t& tiles) {
 	/* Merge the arranged tiles into one larger tile */
 	const tile_t merged = merge_tiles(0, arranged);
 
-	/* Iterate through all orientations of merged tile until we find one
-	 * that we can erase sea monsters from. 
+	/* Look at the merged tile in each orientation until we find one
+	 * that we can erase sea monsters from.
 	 * Return the number of '#' chars left.
 	*/
-	for (tile_t &tile : tile_transforms(merged)) {
-		if (erase_monsters(tile) != 0) {
-			return tile.count_char('#');
+	for (unsigned i = 0; i < grid_view_t<>::orientations; i++) {
+		size_t erased = erase_monsters(merged.view().orientation(i));
+		if (erased != 0) {
+			return merged.count_char('#') - erased;
 		}
 	}
 
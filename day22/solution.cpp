@@ -13,6 +13,7 @@
 #include <deque>
 #include <unordered_set>
 
+#include "split.h"	// parse_ints
 
 using namespace std;
 
@@ -38,7 +39,7 @@ const data_t read_data(const string& filename) {
 			data.push_back(deck);
 			deck.clear();
 		} else if (isdigit(line[0])) {
-			deck.push_back(stoul(line));
+			parse_ints<size_t>(line, deck);
 		}
 	}
 
@@ -0,0 +1,69 @@
+#include "hugepage.h"
+
+#include <sys/mman.h>  // mmap, madvise
+
+#include <cstdint>  // uintptr_t
+#include <limits>   // numeric_limits
+#include <new>	   // bad_alloc
+
+/* Round bytes up to a whole number of huge pages. */
+static size_t huge_page_round(size_t bytes) {
+	return (bytes + huge_page_size - 1) & ~(huge_page_size - 1);
+}
+
+/* Allocate bytes backed by huge pages.
+ * First try explicit huge pages (MAP_HUGETLB), these need to be reserved by
+ * the admin (vm.nr_hugepages) so often are not there. Then fall back to normal
+ * pages and ask for transparent huge pages (MADV_HUGEPAGE). If the kernel will
+ * not do either we still get working (small page) memory.
+ */
+void* huge_page_alloc(size_t bytes) {
+	// rounding up and the alignment padding below must not wrap
+	if (bytes > std::numeric_limits<size_t>::max() - 2 * huge_page_size) {
+		throw std::bad_alloc();
+	}
+
+	size_t length = huge_page_round(bytes);
+	void* ptr = MAP_FAILED;
+
+#if defined(MAP_HUGETLB)
+	ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+			   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+
+	if (ptr == MAP_FAILED) {
+		// over allocate so we can trim to a huge page boundary,
+		// the kernel only uses transparent huge pages for aligned 2MB runs.
+		size_t padded = length + huge_page_size;
+		void* raw = mmap(nullptr, padded, PROT_READ | PROT_WRITE,
+						 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (raw == MAP_FAILED) {
+			throw std::bad_alloc();
+		}
+
+		uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+		uintptr_t aligned = (start + huge_page_size - 1) & ~(huge_page_size - 1);
+		size_t head = aligned - start;
+		size_t tail = padded - head - length;
+		if (head) {
+			munmap(raw, head);
+		}
+		if (tail) {
+			munmap(reinterpret_cast<void*>(aligned + length), tail);
+		}
+		ptr = reinterpret_cast<void*>(aligned);
+
+#if defined(MADV_HUGEPAGE)
+		// only a hint, ignore failure (e.g. THP set to "never")
+		madvise(ptr, length, MADV_HUGEPAGE);
+#endif
+	}
+
+	return ptr;
+}
+
+void huge_page_free(void* ptr, size_t bytes) {
+	if (ptr != nullptr) {
+		munmap(ptr, huge_page_round(bytes));
+	}
+}
@@ -5,12 +5,15 @@
 #include <chrono>	  // high resolution timer
 #include <cstring>	  // strtok, strdup
 #include <fstream>	  // ifstream (reading file)
+#include <future>	  // async (parallel parts)
 #include <numeric>	  // max, reduce, etc.
 #include <print>
 #include <ranges>  // ranges and views
 #include <string>  // strings
 #include <vector>  // collection
 
+#include "hugepage.h"	// huge page backed tables
+
 using namespace std;
 
 /* Update with data type and result types */
@@ -38,8 +41,13 @@ const data_t read_data(const string& filename) {
 	return data;
 }
 
+/* Next cup for each cup label. Part 2 chases 10M links through 1M cups,
+ * huge pages keep that from being bound by TLB misses.
+ */
+using cups_t = vector<size_t, huge_page_allocator_t<size_t>>;
+
 /* Print the cups... */
-void print_cups(const vector<size_t>& cups, size_t current) {
+void print_cups(const cups_t& cups, size_t current) {
 	print("({}) ", current);
 	for (size_t next = current; cups[next] != current; next = cups[next]) {
 		print("{} ", cups[next]);
@@ -49,7 +57,7 @@ void print_cups(const vector<size_t>& cups, size_t current) {
 /* Return the destination cup, given the `current` cup.
  * The next lowest value label or restart from the highest if none below.
  */
-size_t find_destination(const vector<size_t> &cups, size_t current) {
+size_t find_destination(const cups_t &cups, size_t current) {
 	size_t label = (current == 1 ? cups.size() : current) - 1;
 
 	while (cups[current] == label
@@ -67,7 +75,7 @@ size_t find_destination(const vector<size_t> &cups, size_t current) {
  */
 vector<size_t> move_cups(const data_t& data, const size_t moves) {
 	// Create vector where label is index and value is location of next cup
-	vector<size_t> cups(data.size()+1);
+	cups_t cups(data.size()+1);
 	for (size_t i = 0; i < data.size(); i++) {
 		cups[data[i]] = data[(i + 1) % data.size()];
 	}
@@ -132,13 +140,17 @@ result_t part2(const data_t data) {
 
 int main(int argc, char* argv[]) {
 	bool verbose = false;
+	bool parallel = false;
 
 	int c;
-	while ((c = getopt(argc, argv, "v")) != -1) {
+	while ((c = getopt(argc, argv, "vp")) != -1) {
 		switch (c) {
 			case 'v':
 				verbose = !verbose;
 				break;
+			case 'p':
+				parallel = !parallel;
+				break;
 			default:
 				std::print(stderr, "ERROR: Unknown option \"{}\"\n", c);
 				exit(1);
@@ -164,18 +176,39 @@ int main(int argc, char* argv[]) {
 		print("{:>15} ({:>10.4f}ms)\n", "parse", parse_time.count());
 	}
 
-	result_t p1_result = part1(data);
+	/* Run one part on the data, returning its result and how long it took. */
+	auto run_part = [&data](auto part) -> pair<result_t, duration_t> {
+		auto part_start = chrono::high_resolution_clock::now();
+		result_t result = part(data);
+		duration_t part_time = chrono::high_resolution_clock::now() - part_start;
+		return {result, part_time};
+	};
+
+	pair<result_t, duration_t> p1, p2;
+	if (parallel) {
+		// both parts only read data, so each can run on its own thread
+		auto p1_future = async(launch::async, run_part, part1);
+		auto p2_future = async(launch::async, run_part, part2);
+		p1 = p1_future.get();
+		p2 = p2_future.get();
+	} else {
+		p1 = run_part(part1);
+		p2 = run_part(part2);
+	}
+
+	auto parts_complete = chrono::high_resolution_clock::now();
 
-	auto p1_complete = chrono::high_resolution_clock::now();
-	duration_t p1_time = p1_complete - parse_complete;
+	auto [p1_result, p1_time] = p1;
 	print("{:>15} ({:>10.4f}ms){}", p1_result, p1_time.count(), verbose ? "\n" : "");
 
-	result_t p2_result = part2(data);
-
-	auto p2_complete = chrono::high_resolution_clock::now();
-	duration_t p2_time = p2_complete - p1_complete;
+	auto [p2_result, p2_time] = p2;
 	print("{:>15} ({:>10.4f}ms){}", p2_result, p2_time.count(), verbose ? "\n" : "");
 
-	duration_t total_time = p2_complete - start_time;
+	if (verbose) {
+		duration_t wall_time = parts_complete - parse_complete;
+		print("{:>15} ({:>10.4f}ms)\n", parallel ? "parallel" : "sequential", wall_time.count());
+	}
+
+	duration_t total_time = parts_complete - start_time;
 	print("{:>15} ({:>10.4f}ms)\n", "total", total_time.count());
 }
@@ -10,22 +10,26 @@
 #include <ranges>  // ranges and views
 #include <string>  // strings
 #include <vector>  // collection
-#include <unordered_set>
 
 #include "point.h"
+#include "point_map.h"
+#include "sparse_grid.h"
 
 using namespace std;
 
+/* Axial coordinate of a hex tile, 8 bytes rather than point_t's 32 */
+using hex_t = point<2, int32_t>;
+
 /* Update with data type and result types */
-using data_t = vector<vector<point_t>>;
+using data_t = vector<vector<hex_t>>;
 using result_t = size_t;
 
 /* for pretty printing durations */
 using duration_t = chrono::duration<double, milli>;
 
 /* Return the direction on hexagonal grid to go based on hexagonal directions */
-vector<point_t> parse_directions(const string &line) {
-	vector<point_t> dirs;
+vector<hex_t> parse_directions(const string &line) {
+	vector<hex_t> dirs;
 
 	size_t pos = 0;
 	while (pos < line.length()) {
@@ -86,11 +90,11 @@ const data_t read_data(const string& filename) {
 /* Return the set of active cells based on the hexagonal navigation
  * directions given in `data`.
  */
-unordered_set<point_t> build_active(const data_t & data) {
-	unordered_set<point_t> active;
+point_set_t<hex_t> build_active(const data_t & data) {
+	point_set_t<hex_t> active;
 
 	for (const auto & dirs : data) {
-		point_t p {0, 0};
+		hex_t p {0, 0};
 
 		for (const auto & dir : dirs) {
 			p += dir;
@@ -108,87 +112,62 @@ unordered_set<point_t> build_active(const data_t & data) {
 
 /* Part 1 */
 result_t part1(const data_t& data) {
-	unordered_set<point_t> current = build_active(data);
+	point_set_t<hex_t> current = build_active(data);
 	return current.size();
 }
 
-/* Return the min/max bounds of the current cells. */
-pair<point_t, point_t> get_bounds(const unordered_set<point_t>& current) {
-	point_t p_min {*current.begin()};
-	point_t p_max {*current.begin()};
-
-	for (const auto & p : current) {
-		p_min.x = min(p_min.x, p.x);
-		p_min.y = min(p_min.y, p.y);
-
-		p_max.x = max(p_max.x, p.x);
-		p_max.y = max(p_max.y, p.y);
-	}
-
-	return {p_min, p_max};
-}
+/* Tiles on the hex floor, 1 for active (black) */
+using floor_t = sparse_grid_t<uint8_t>;
 
-/* Return the min/max bounds outset by given offset */
-pair<point_t, point_t> outset(const pair<point_t, point_t> & r, dimension_t offset) {
-	return {{r.first.x - offset, r.first.y - offset}, 
-			{r.second.x + offset, r.second.y + offset}};
-}
-
-/* Return the number of active neighbors based on hexagonal grid.
- * There are 6 neighboring cells
+/* Return the next iteration of the world, based on:
+ * - active tile with 1 or 2 neighbors persists to next iteration
+ * - inactive tile becomes active with exactly 2 neighbors
+ * Each active tile adds one to its 6 neighbors' counts, then only cells in
+ * blocks that got a count are checked.
  */
-size_t neighbor_count(const unordered_set<point_t>& current, const point_t &p) {
-	vector<point_t> dirs = {{1, -1}, {-1, 1}, {0, -1}, {-1, 0}, {1, 0}, {0, 1}};
+floor_t sparse_step(const floor_t& current) {
+	static const vector<point_t> dirs = {{1, -1}, {-1, 1}, {0, -1}, {-1, 0}, {1, 0}, {0, 1}};
 
-	size_t neighbors = 0;
-	for (const auto& d : dirs) {
-		if (current.contains(p + d)) {
-			neighbors += 1;
+	floor_t counts;
+	current.for_each([&counts](const point_t& p, uint8_t) {
+		for (const auto& d : dirs) {
+			counts.at(p + d)++;
 		}
-	}
+	});
 
-	return neighbors;
-}
+	floor_t next;
+	counts.for_each_block([&current, &next](const floor_t::block_t& block) {
+		// matching block of current tiles, if any, looked up once per block
+		const floor_t::block_t* tiles = current.find_block(floor_t::block_key(block.origin));
 
-/* Return the next iteration of the world, based on:
- * - active tile with 1 or 2 neighbors persists to next iteration
- * - inactive tile becomes active with exactly 2 neighbors
- */
-unordered_set<point_t> step(const unordered_set<point_t> & current) {
-	// outset the bounds enough to account for hexagonal grid
-	auto [p_min, p_max] = outset(get_bounds(current), 2);
-
-	// generate next set of active cells
-	unordered_set<point_t> next;
-	for (auto y = p_min.y; y < p_max.y; y++) {
-		for (auto x = p_min.x; x < p_max.x; x++) {
-			const point_t p {x, y};
-			auto neighbors = neighbor_count(current, p);
-			auto is_active = current.contains(p);
-
-			if (is_active && (neighbors == 1 || neighbors == 2)) {
-				// is active and has 1 or 2 neighbors, persist
-				next.insert(p);
-			} else if (!is_active && neighbors == 2) {
-				// is inactive and has exactly 2 neighbors, become active
-				next.insert(p);
+		for (dimension_t y = 0; y < floor_t::block_size; y++) {
+			for (dimension_t x = 0; x < floor_t::block_size; x++) {
+				auto neighbors = block.cell(x, y);
+				auto is_active = tiles != nullptr && tiles->cell(x, y);
+
+				if (neighbors == 2 || (is_active && neighbors == 1)) {
+					next.set({block.origin.x + x, block.origin.y + y}, 1);
+				}
 			}
 		}
-	}
+	});
 
 	return next;
 }
 
 /* Part 2 */
 result_t part2(const data_t& data) {
-	unordered_set<point_t> current = build_active(data);
+	floor_t current;
+	for (const auto& p : build_active(data)) {
+		current.set(point_t(p), 1);
+	}
 
 	for (size_t day = 0; day < 100; day++) {
-		auto next = step(current);		
+		auto next = sparse_step(current);
 		swap(next, current);
 	}
 
-	return current.size();
+	return current.count();
 }
 
 int main(int argc, char* argv[]) {
@@ -9,8 +9,11 @@
 #include <print>
 #include <ranges>  // ranges and views
 #include <string>  // strings
+#include <iterator>  // istreambuf_iterator
 #include <vector>  // collectin
 
+#include "split.h"	// parse_ints
+
 using namespace std;
 
 /* Update with data type and result types */
@@ -24,14 +27,10 @@ using duration_t = chrono::duration<double, milli>;
 const data_t read_data(const string& filename) {
 	data_t data;
 
+	// one number per line, parse the whole file in one go
 	std::ifstream ifs(filename);
-
-	string line;
-	while (getline(ifs, line)) {
-		if (!line.empty()) {
-			data.push_back(stoul(line));
-		}
-	}
+	string text{istreambuf_iterator<char>(ifs), istreambuf_iterator<char>()};
+	parse_ints<size_t>(text, data);
 
 	return data;
 }
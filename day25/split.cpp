@@ -0,0 +1,86 @@
+#include "split.h"
+
+#include <charconv>	 // from_chars
+#include <fstream>	 // ifstream (reading file)
+#include <iostream>	 // cout
+
+using namespace std;
+
+std::vector<std::string> split(const std::string& str, const std::string& delims) {
+	std::vector<std::string> tokens;
+
+	for (const auto token : split_view(str, delims)) {
+		tokens.emplace_back(token);
+	}
+
+	return tokens;
+}
+
+std::vector<float> split_float(const std::string& str, const std::string& delims) {
+	std::vector<float> numbers;
+
+	for (const auto s : split_view(str, delims)) {
+		if (isdigit(s[0]) || s[0] == '-') {
+			// no from_chars for float in libc++ yet
+			numbers.push_back(std::stof(std::string(s)));
+		}
+	}
+
+	return numbers;
+}
+
+std::vector<int> split_int(const std::string& str, const std::string& delims) {
+	std::vector<int> numbers;
+
+	for (const auto s : split_view(str, delims)) {
+		if (isdigit(s[0]) || s[0] == '-') {
+			int n = 0;
+			if (std::from_chars(s.data(), s.data() + s.size(), n).ec == std::errc()) {
+				numbers.push_back(n);
+			}
+		}
+	}
+
+	return numbers;
+}
+
+std::vector<size_t> split_size_t(const std::string& str, const std::string& delims) {
+	std::vector<size_t> numbers;
+
+	for (const auto s : split_view(str, delims)) {
+		if (isdigit(s[0])) {
+			size_t n = 0;
+			if (std::from_chars(s.data(), s.data() + s.size(), n).ec == std::errc()) {
+				numbers.push_back(n);
+			}
+		}
+	}
+
+	return numbers;
+}
+
+void test_split() {
+	cout << "Testing split functions..." << endl;
+
+	string test_str = "12, 34;56=78 abc -90";
+
+	auto str_tokens = split(test_str);
+	cout << "String tokens:" << endl;
+	for (const auto& token : str_tokens) {
+		cout << "[" << token << "]" << endl;
+	}
+
+	auto int_tokens = split_int(test_str);
+	cout << "Integer tokens:" << endl;
+	for (const auto& token : int_tokens) {
+		cout << "[" << token << "]" << endl;
+	}
+
+	auto float_tokens = split_float(test_str, ", =;");
+	cout << "Float tokens:" << endl;
+	for (const auto& token : float_tokens) {
+		cout << "[" << token << "]" << endl;
+	}
+
+	cout << "Split functions test completed." << endl;
+}